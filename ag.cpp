@@ -12,6 +12,10 @@
 
 #include "ag.hpp"
 #include <iostream>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //Apenas letura
 TMapaGenes *TAlgGenetico::getMapa() { return VP_Mapa; }
@@ -34,6 +38,14 @@ void TAlgGenetico::setSelecao (int val)                 { VP_selecao
 void TAlgGenetico::setSelIndMutacao (int val)           { VP_selIndMutacao           = val; }
 void TAlgGenetico::setPercentReducao (int val)          { VP_percentReducao          = val; }
 void TAlgGenetico::setPercentMutacaoRecursiva (int val) { VP_percentMutacaoRecursiva = val; }
+void TAlgGenetico::setRotaInicial (int val)             { VP_rotaInicial             = val; }
+void TAlgGenetico::setMinDoisNiveis (int val)           { VP_minDoisNiveis           = val; }
+void TAlgGenetico::setTamCacheReduzidos (int val)       { VP_tamCacheReduzidos       = val; }
+void TAlgGenetico::setCacheReduzidos (TCacheReduzidos *cache) { VP_cache = cache; }
+void TAlgGenetico::setNumThreads (int val)              { VP_numThreads              = val; }
+void TAlgGenetico::setTempoMaximo (int val)             { VP_tempoMaximo             = val; }
+void TAlgGenetico::setMaxAvaliacoes (int val)           { VP_maxAvaliacoes           = val; }
+void TAlgGenetico::setOrcamento (TOrcamento *orcamento) { VP_orcamento = orcamento; }
 
 int TAlgGenetico::getPercentReducao ()          { return VP_percentReducao; }
 int TAlgGenetico::getPercentMutacaoRecursiva () { return VP_percentMutacaoRecursiva; }
@@ -48,6 +60,12 @@ int TAlgGenetico::getCruzamento ()              { return VP_cruzamento; }
 int TAlgGenetico::getPercentElitismo ()         { return VP_percentElitismo; }
 int TAlgGenetico::getSelecao ()                 { return VP_selecao; }
 int TAlgGenetico::getSelIndMutacao ()           { return VP_selIndMutacao; }
+int TAlgGenetico::getRotaInicial ()             { return VP_rotaInicial; }
+int TAlgGenetico::getMinDoisNiveis ()           { return VP_minDoisNiveis; }
+int TAlgGenetico::getTamCacheReduzidos ()       { return VP_tamCacheReduzidos; }
+int TAlgGenetico::getNumThreads ()              { return VP_numThreads; }
+int TAlgGenetico::getTempoMaximo ()             { return VP_tempoMaximo; }
+int TAlgGenetico::getMaxAvaliacoes ()           { return VP_maxAvaliacoes; }
 
 unsigned TAlgGenetico::getEntradaRec() { return VP_Entr_Rec; }
 unsigned TAlgGenetico::getExecRec()    { return VP_Exec_Rec; }
@@ -66,6 +84,18 @@ TAlgGenetico::TAlgGenetico (TMapaGenes *mapa, TArqLog *arqSaida)
 	VP_Entr_Rec 	 = 0;
 	VP_Exec_Rec     = 0;
 	VP_Comb_Rec     = 0;
+   VP_rotaInicial  = 0;
+   VP_minDoisNiveis = 0;
+   VP_tamCacheReduzidos = 0;
+   VP_numThreads   = 1;
+   VP_tempoMaximo  = 0;
+   VP_maxAvaliacoes = 0;
+   VP_cache        = NULL;
+   VP_tabNivel     = NULL;
+   VP_orcamento    = NULL;
+   VP_filhosPorCruzamento = 2;
+   VP_pool         = NULL;
+   VP_reserva      = NULL;
 }
 
 TAlgGenetico::TAlgGenetico (TMapaGenes *mapa, TArqLog *arqSaida, int profundidade)
@@ -76,6 +106,18 @@ TAlgGenetico::TAlgGenetico (TMapaGenes *mapa, TArqLog *arqSaida, int profundidad
 	VP_Entr_Rec     = 0;
 	VP_Exec_Rec     = 0;
 	VP_Comb_Rec     = 0;
+   VP_rotaInicial  = 0;
+   VP_minDoisNiveis = 0;
+   VP_tamCacheReduzidos = 0;
+   VP_numThreads   = 1;
+   VP_tempoMaximo  = 0;
+   VP_maxAvaliacoes = 0;
+   VP_cache        = NULL;
+   VP_tabNivel     = NULL;
+   VP_orcamento    = NULL;
+   VP_filhosPorCruzamento = 2;
+   VP_pool         = NULL;
+   VP_reserva      = NULL;
 }
 
 TAlgGenetico::~TAlgGenetico ()
@@ -97,48 +139,79 @@ void TAlgGenetico::exec(TIndividuo *indBase, TTabConversao *tabConversao, int ex
 {  
    //Limitando a profundidade da recursivdade
    if (get_profundidade() >= getProfundidadeMaxima()) return;
+   VP_tabNivel = tabConversao;
    
    TIndividuo *melhor;
-   mutacao = new TMutacao(getMapa(), getArqLog(), getMutacao());
+   mutacao = new TMutacao(getMapa(), getArqLog(), getMutacao(), getMinDoisNiveis());
    cruzamento = new TCruzamento(getMapa(), getArqLog(), getCruzamento());
    
    int tam = getTamPopulacao();
    if (tam>2*tabConversao->get_quantidade()) tam=2*tabConversao->get_quantidade();
    
-   TPopulacao *populacao = new TPopulacao (tam, getMapa(), getArqLog());
-   vector<TTipoConversao> tc = tabConversao->get_vetConv();
-   populacao->povoa(tc, extraPadrao);
+   VP_pool = new TPoolIndividuos(getMapa(), getArqLog(), tam);
+   TPopulacao *populacao = new TPopulacao (tam, getMapa(), getArqLog(), VP_pool);
+   VP_reserva = new TPopulacao (tam, getMapa(), getArqLog(), VP_pool);
+   //Os genes são as cidades do mapa reduzido (getMapa), um por fragmento
+   populacao->povoa(tabConversao->get_vetConvReduzido(), extraPadrao);
    melhor = populacao->get_melhor();
    populacao->ordena();
    	   
    double mdAtu = melhor->get_distancia();
+
+   //Com orçamento, as gerações dependem do rendimento desta profundidade e redução
+   int faixa = TOrcamento::get_faixa(tabConversao->get_quantidade(), indBase->get_qtdeGenes());
+   int maxGeracao = (VP_orcamento)?VP_orcamento->get_geracoes(get_profundidade(), faixa, getMaxGeracao()):getMaxGeracao();
+   double distAntes = indBase->get_distancia();
+   unsigned long avaliacoesAntes = (VP_orcamento)?VP_orcamento->get_avaliacoes():0;
+   double tempoAntes = (VP_orcamento)?VP_orcamento->get_tempo():0;
    
-   for (int i=1; i<=getMaxGeracao(); i++)
+   for (int i=1; i<=maxGeracao; i++)
    {
       populacao = iteracao (populacao, i);
 		melhor = populacao->get_melhor();
 		if(melhor->get_distancia()<mdAtu) mdAtu = melhor->get_distancia();
 		else if (get_profundidade() > 0) break;
+      if ((VP_orcamento)&&(VP_orcamento->is_esgotado())) break;
    }
 
    delete mutacao;
    delete cruzamento;
 
+   //A melhor rota do problema reduzido fica para as próximas vezes em que ele aparecer
+   if (VP_cache)
+   {
+      TIndividuo *melhorReduzido = populacao->get_melhor();
+      vector<int> rota(melhorReduzido->get_qtdeGenes());
+      for (int i=0; i<melhorReduzido->get_qtdeGenes(); i++) rota[i] = melhorReduzido->get_por_indice(i)->id;
+      VP_cache->guarda(tabConversao->get_chave(), rota, melhorReduzido->get_distancia());
+   }
+
    tabConversao->converte(indBase, populacao->get_melhor());
+
+   if (VP_orcamento)
+      VP_orcamento->registra(get_profundidade(), faixa, distAntes-indBase->get_distancia(),
+                             VP_orcamento->get_avaliacoes()-avaliacoesAntes, VP_orcamento->get_tempo()-tempoAntes);
    
-   tc.clear();
    delete populacao;
+   delete VP_reserva;
+   VP_reserva = NULL;
+   delete VP_pool;
+   VP_pool = NULL;
 }
    
 void TAlgGenetico::exec()
 {
    TIndividuo *melhor;
-   mutacao = new TMutacao(getMapa(), getArqLog(), getMutacao());
+   mutacao = new TMutacao(getMapa(), getArqLog(), getMutacao(), getMinDoisNiveis());
    cruzamento = new TCruzamento(getMapa(), getArqLog(), getCruzamento());
 
    VP_melhor_dist = infinito;
-   TPopulacao *populacao = new TPopulacao (getTamPopulacao(), getMapa(), getArqLog());
-   populacao->povoa();
+   VP_pool = new TPoolIndividuos(getMapa(), getArqLog(), getTamPopulacao());
+   TPopulacao *populacao = new TPopulacao (getTamPopulacao(), getMapa(), getArqLog(), VP_pool);
+   VP_reserva = new TPopulacao (getTamPopulacao(), getMapa(), getArqLog(), VP_pool);
+   if (getTamCacheReduzidos()>0) VP_cache = new TCacheReduzidos(getTamCacheReduzidos());
+   VP_orcamento = new TOrcamento(getTempoMaximo(), 1000UL*getMaxAvaliacoes(), getProfundidadeMaxima());
+   populacao->povoa(getRotaInicial());
 /*
 //Descomente para teste de cruzamento
 TIndividuo *i1 = populacao->get_individuo(0);
@@ -166,6 +239,15 @@ return;
          VP_melhor_dist = melhor->get_distancia();	
 			VP_melhor_gera = i;
 	  }
+
+      if (VP_orcamento->is_esgotado())
+      {
+         string lin = "Orçamento esgotado;Geração;";
+         lin += to_string(i);
+         VP_ArqSaida->addLinha(lin);
+         if (getPrintParcial()) cout << endl << lin << endl;
+         break;
+      }
    }
 
    if (getPrintParcial())
@@ -208,20 +290,45 @@ return;
    strFimExec += to_string(getCombinaRec());
    VP_ArqSaida->addLinha(strFimExec);
 
+   if (VP_cache)
+   {
+      strFimExec = "Cache de Reduzidos;Acertos;";
+      strFimExec += to_string(VP_cache->get_acertos());
+      strFimExec += "; Falhas;";
+      strFimExec += to_string(VP_cache->get_falhas());
+      VP_ArqSaida->addLinha(strFimExec);
+      if (getPrintParcial()) cout << strFimExec << endl;
+
+      delete VP_cache;
+      VP_cache = NULL;
+   }
+
+   VP_ArqSaida->addTexto(VP_orcamento->toString());
+   delete VP_orcamento;
+   VP_orcamento = NULL;
+
    VP_ArqSaida->addLinha("");
    
    delete populacao;
+   delete VP_reserva;
+   VP_reserva = NULL;
+   delete VP_pool;
+   VP_pool = NULL;
 }
 
 TPopulacao *TAlgGenetico::iteracao (TPopulacao *populacao, int geracao)
 {
-   TPopulacao *novaPop = new TPopulacao(populacao->get_tamanho(), populacao->getMapa(), populacao->getArqLog());
+   //A nova geração é escrita na população de reserva. A anterior devolve
+   //seus indivíduos ao pool e passa a ser a reserva da próxima geração
+   TPopulacao *novaPop = VP_reserva;
    elitismo(novaPop, populacao);
    geraDescendentes(novaPop, populacao, geracao);
    fazMutacao(novaPop);
    novaPop->ordena();
+   if (VP_orcamento) VP_orcamento->consome(get_profundidade(), novaPop->get_tamanho());
 
-   delete populacao;
+   populacao->esvazia();
+   VP_reserva = populacao;
 
    time(&sysTime2);
    TIndividuo *melhor = novaPop->get_melhor();  
@@ -273,36 +380,71 @@ void TAlgGenetico::elitismo(TPopulacao *novaPop, TPopulacao *populacao)
    }
 }
 
-void TAlgGenetico::geraDescendentes(TPopulacao *novaPop, TPopulacao *populacao, int geracao)
+int TAlgGenetico::get_qtdeThreads()
 {
-   int i;
-   int j;
-   TIndividuo *ind1;
-   TIndividuo *ind2;
+   //Só a execução principal abre threads. Nos AGs recursivos a
+   //execução já está na thread de uma tarefa
+   int qtdeThreads = 1;
+#ifdef _OPENMP
+   if (get_profundidade()==0) qtdeThreads = (getNumThreads()>0)?getNumThreads():omp_get_max_threads();
+#endif
+   return qtdeThreads;
+}
 
-   TSelecao *selecao = new TSelecao (VP_Mapa, VP_ArqSaida, VP_selecao);
-	
+void TAlgGenetico::geraDescendentes(TPopulacao *novaPop, TPopulacao *populacao, int geracao)
+{
    while (novaPop->get_qtdeIndividuo()<novaPop->get_tamanho())
    {
-      i = selecao->processa(populacao);
-      j = selecao->processa(populacao, i);
+      //Os cruzamentos de uma rodada são independentes: cada um tem a sua posição
+      //e a sua semente, sorteada em ordem, e dá o mesmo resultado em qualquer
+      //thread. A quantidade usa a média de filhos por cruzamento das rodadas
+      //anteriores, e os filhos que sobrarem voltam para o pool
+      int faltam = novaPop->get_tamanho() - novaPop->get_qtdeIndividuo();
+      int qtdeCruzamentos = (int) ceil(faltam / VP_filhosPorCruzamento);
+
+      vector<uint64_t> sementes(qtdeCruzamentos);
+      vector< vector<TIndividuo *> > filhos(qtdeCruzamentos);
+      for (int c=0; c<qtdeCruzamentos; c++) sementes[c] = TUtils::sorteiaSemente();
 
-      ind1 = populacao->get_individuo(i);
-      ind2 = populacao->get_individuo(j);
+      int qtdeThreads = get_qtdeThreads();
+      if (qtdeThreads>qtdeCruzamentos) qtdeThreads = qtdeCruzamentos;
 
-      if (ind1->get_distancia()==ind2->get_distancia())
+      #pragma omp parallel num_threads(qtdeThreads) if(qtdeThreads>1)
       {
-         ind1 = ind2->clona();
-         novaPop->add_individuo(ind1);
+         //Operadores da thread
+         TSelecao selecao(VP_Mapa, VP_ArqSaida, VP_selecao);
+         TCruzamento cruzamentoThread(getMapa(), getArqLog(), getCruzamento());
+         uint64_t estado = TUtils::get_estadoRnd();
+
+         #pragma omp for schedule(dynamic, 1)
+         for (int c=0; c<qtdeCruzamentos; c++)
+         {
+            TUtils::initRnd(sementes[c]);
+
+            int i = selecao.processa(populacao);
+            int j = selecao.processa(populacao, i);
+
+            TIndividuo *ind1 = populacao->get_individuo(i);
+            TIndividuo *ind2 = populacao->get_individuo(j);
+
+            if (ind1->get_distancia()==ind2->get_distancia())
+               filhos[c].push_back(ind2->clona());
+            else
+               filhos[c] = cruzamentoThread.processa(ind1, ind2, populacao, getMaxGeracao(), geracao);
+         }
+
+         TUtils::set_estadoRnd(estado);
       }
-      else
-		{
-			novaPop->add_individuo(cruzamento->processa(ind1, ind2, populacao, getMaxGeracao(), geracao));
-		}
-         
+
+      //Na ordem dos cruzamentos
+      unsigned qtdeFilhos = 0;
+      for (int c=0; c<qtdeCruzamentos; c++)
+      {
+         qtdeFilhos += filhos[c].size();
+         novaPop->add_individuo(filhos[c]);
+      }
+      if (qtdeFilhos>0) VP_filhosPorCruzamento = (double) qtdeFilhos / qtdeCruzamentos;
    }
-	
-	delete selecao;
 }
 
 void TAlgGenetico::fazMutacao(TPopulacao *populacao)
@@ -311,6 +453,8 @@ void TAlgGenetico::fazMutacao(TPopulacao *populacao)
    int qtdeMutacao          = populacao->get_tamanho() * getPercentMutacao() / 100;
 	int qtdeMutacaoRecursiva = populacao->get_tamanho() * getPercentMutacaoRecursiva() / 100;
 
+   //Indivíduos que sofrerão mutação, sorteados sem reposição
+   vector<int> alvos;
    switch (getSelIndMutacao())
    {
       case 0:  //O melhor nunca sofre mutação
@@ -320,9 +464,7 @@ void TAlgGenetico::fazMutacao(TPopulacao *populacao)
       }
       case 1:  //O melhor sempre sofre mutação
       {
-         populacao->sub_dist_tot((populacao->get_individuo(0))->get_distancia());
-         mutacao->processa(populacao->get_individuo(0));
-         populacao->soma_dist_tot((populacao->get_individuo(0))->get_distancia());
+         if (qtdeMutacao>0) alvos.push_back(0);
          ini = 1;
          qtdeMutacao--;
          break;
@@ -333,58 +475,143 @@ void TAlgGenetico::fazMutacao(TPopulacao *populacao)
       }
    }
 
+   vector<int> candidatos;
+   for (int i=ini; i<(int)populacao->get_tamanho(); i++) candidatos.push_back(i);
+   if (qtdeMutacao>(int)candidatos.size()) qtdeMutacao = candidatos.size();
+
+   //Fisher-Yates parcial: os primeiros qtdeMutacao candidatos
    for (int i=0; i < qtdeMutacao; i++)
    {
-      int j = TUtils::rnd (ini, populacao->get_tamanho()-1);
+      int j = TUtils::rnd (i, candidatos.size()-1);
+      swap(candidatos[i], candidatos[j]);
+      alvos.push_back(candidatos[i]);
+   }
 
-      populacao->sub_dist_tot((populacao->get_individuo(j))->get_distancia());
+   //Cada mutação tem a sua semente, sorteada em ordem, e manipula um
+   //indivíduo diferente. O resultado não depende da quantidade de threads
+   int qtdeAlvos = alvos.size();
+   vector<uint64_t> sementes(qtdeAlvos);
+   for (int a=0; a<qtdeAlvos; a++) sementes[a] = TUtils::sorteiaSemente();
 
-      mutacao->processa(populacao->get_individuo(j));
+   int qtdeThreads = get_qtdeThreads();
+   if (qtdeThreads>qtdeAlvos) qtdeThreads = qtdeAlvos;
+
+   #pragma omp parallel num_threads(qtdeThreads) if(qtdeThreads>1)
+   {
+      //O TMutacao guarda a rota de dois níveis do 2-opt: um por thread
+      TMutacao mutacaoThread(getMapa(), getArqLog(), getMutacao(), getMinDoisNiveis());
+      uint64_t estado = TUtils::get_estadoRnd();
 
-      populacao->soma_dist_tot((populacao->get_individuo(j))->get_distancia());
+      #pragma omp for schedule(dynamic, 1)
+      for (int a=0; a<qtdeAlvos; a++)
+      {
+         TUtils::initRnd(sementes[a]);
+         mutacaoThread.processa(populacao->get_individuo(alvos[a]));
+      }
+
+      TUtils::set_estadoRnd(estado);
    }
 
+   //Sorteio das mutações recursivas. Cada tarefa recebe a sua semente aqui,
+   //na ordem do sorteio, e não depende da thread que a executar
+   vector<TTarefaRecursiva> tarefas;
+   vector<bool> sorteado(populacao->get_tamanho(), false);
    for (int i=0; i < qtdeMutacaoRecursiva; i++)
    {
       int j = TUtils::rnd (1, populacao->get_tamanho()-1);
 
-      populacao->sub_dist_tot((populacao->get_individuo(j))->get_distancia());
+      //Duas tarefas não podem manipular o mesmo indivíduo ao mesmo tempo
+      if (sorteado[j]) continue;
+      sorteado[j] = true;
+
+      TTarefaRecursiva tarefa;
+      tarefa.indice      = j;
+      tarefa.semente     = TUtils::sorteiaSemente();
+      tarefa.arqLog      = new TArqLog();
+      tarefa.cache       = (VP_cache)?new TCacheReduzidos(VP_cache->get_capacidade(), VP_cache):NULL;
+      tarefa.orcamento   = (VP_orcamento)?new TOrcamento(VP_orcamento):NULL;
+      tarefa.entradas    = 0;
+      tarefa.execucoes   = 0;
+      tarefa.combinacoes = 0;
+      tarefas.push_back(tarefa);
+   }
+
+   //Todas comparam com o melhor do início da fase. Ele está na posição 0,
+   //que não é sorteada, e não muda até o fim das tarefas
+   TIndividuo *melhor = populacao->get_melhor();
+
+   qtdeThreads = get_qtdeThreads();
+   int qtdeTarefas = tarefas.size();
+   if (qtdeThreads>qtdeTarefas) qtdeThreads = qtdeTarefas;
+
+   #pragma omp parallel for schedule(dynamic, 1) num_threads(qtdeThreads) if(qtdeThreads>1)
+   for (int t=0; t<qtdeTarefas; t++)
+   {
+      uint64_t estado = TUtils::get_estadoRnd();
+      TUtils::initRnd(tarefas[t].semente);
 
-      mutacaoAGRecursivo(populacao, j);
+      mutacaoAGRecursivo(tarefas[t], melhor, populacao->get_individuo(tarefas[t].indice), populacao->get_tamanho());
 
-      populacao->soma_dist_tot((populacao->get_individuo(j))->get_distancia());
+      TUtils::set_estadoRnd(estado);
    }
-	
+
+   //Incorpora os resultados na ordem do sorteio
+   for (int t=0; t<qtdeTarefas; t++)
+   {
+      TTarefaRecursiva &tarefa = tarefas[t];
+      TIndividuo *manipulado = populacao->get_individuo(tarefa.indice);
+
+      VP_ArqSaida->addTexto(tarefa.arqLog->get_texto());
+      delete tarefa.arqLog;
+
+      if (tarefa.cache)
+      {
+         VP_cache->incorpora(*tarefa.cache);
+         delete tarefa.cache;
+      }
+
+      if (tarefa.orcamento)
+      {
+         VP_orcamento->incorpora(*tarefa.orcamento);
+         delete tarefa.orcamento;
+      }
+
+      VP_Entr_Rec += tarefa.entradas;
+      VP_Exec_Rec += tarefa.execucoes;
+      VP_Comb_Rec += tarefa.combinacoes;
+
+      if (manipulado->get_distancia()<populacao->get_melhor()->get_distancia()) populacao->troca(0, tarefa.indice);
+   }
+
+   //As somas das distâncias, usadas na seleção, são refeitas uma vez no final
+   populacao->recalculaSomas(get_qtdeThreads());
 }
 
-void TAlgGenetico::mutacaoAGRecursivo(TPopulacao *populacao, int indice)
+void TAlgGenetico::mutacaoAGRecursivo(TTarefaRecursiva &tarefa, TIndividuo *melhor, TIndividuo *manipulado, int tamPopulacao)
 {
-	VP_Entr_Rec++;
+	tarefa.entradas++;
 
    //Tranosformará as sequências, do indivíduo, que coincidem com o melhor em um gene
    TTabConversao *tabConversao;
 
    int qtdeGenes;
    long esforco;
-   long fatorial;
-
-   TIndividuo *melhor = populacao->get_melhor();
-   TIndividuo *manipulado = populacao->get_individuo(indice);
+   double combinacoes;
 
    //Verifico se o esforço
    //(poulação (cruzamento + elitismo))* Número de gerações * (população * %mutação)
-   esforco = (populacao->get_tamanho() * getPercentMutacao()/100) * getMaxGeracao() * populacao->get_tamanho();
+   esforco = (tamPopulacao * getPercentMutacao()/100) * getMaxGeracao() * tamPopulacao;
 
-   //So o fatorial for <= 0 é porque houve overflow
+   //Passos para achar a melhor rota por programação dinâmica
    //-1, pois como é um ciclo, é possível fixar o 0
-   fatorial = TUtils::fatorialStirling(manipulado->get_qtdeGenes()-1);
+   combinacoes = TUtils::esforcoHeldKarp(manipulado->get_qtdeGenes()-1);
 
-   //é maior do que todas as combinações (fatorial) da quantidade de gene
-   //Se a combinação for maior, realiza o AG com os novos genes.
-   //Obs.: o fatorial deve ser > 0, pois provavelmente irá estourar o long
-   if ((fatorial>0)&&(esforco>=fatorial))
+   //é maior do que o custo de achar a melhor rota
+   //Se for maior, realiza o AG com os novos genes.
+   //Obs.: acima de maxGenesExato a memória da programação dinâmica é grande demais
+   if ((manipulado->get_qtdeGenes()<=TIndividuo::maxGenesExato)&&(esforco>=combinacoes))
    {
-   	VP_Comb_Rec++;
+   	tarefa.combinacoes++;
 		
       //Quando o esforço é maior que as combinações
       //O melhor indivuo por combinação
@@ -392,10 +619,12 @@ void TAlgGenetico::mutacaoAGRecursivo(TPopulacao *populacao, int indice)
 
 		if (manipulado->get_distancia()<melhor->get_distancia())
       {
-         populacao->troca(0, indice);
-
-			if(getPrintParcial()) cout << "Melhorou na combinação" << endl;
-         VP_ArqSaida->addLinha ("Melhorou na combinação");
+			if(getPrintParcial())
+         {
+            #pragma omp critical (tela)
+            cout << "Melhorou na combinação" << endl;
+         }
+         tarefa.arqLog->addLinha ("Melhorou na combinação");
 		}
       return;
    }
@@ -403,7 +632,7 @@ void TAlgGenetico::mutacaoAGRecursivo(TPopulacao *populacao, int indice)
    do
    {
       // tentará reduzir a quantidade de gene.
-      tabConversao = new TTabConversao(melhor, manipulado);
+      tabConversao = new TTabConversao(melhor, manipulado, VP_tabNivel);
       qtdeGenes = tabConversao->get_quantidade();
 	  
 		//Obs.: qtdeGenes<=2, pois se for 1, indivíduo é igual ao melhor
@@ -427,36 +656,64 @@ void TAlgGenetico::mutacaoAGRecursivo(TPopulacao *populacao, int indice)
       return;
    }
    
-	VP_Exec_Rec++;
-   //Executando o AG recursivamente
-   TAlgGenetico *ag = new TAlgGenetico(getMapa(), getArqLog(), get_profundidade()+1);
-   ag->setMutacao(getMutacao());
-   ag->setCruzamento(getCruzamento());
-   ag->setTamPopulacao(getTamPopulacao());
-   ag->setPrintParcial(getPrintParcial());
-   ag->setMaxGeracao(getMaxGeracao());
-   ag->setPercentElitismo(getPercentElitismo());
-   ag->setPercentMutacao(getPercentMutacao());
-   ag->setProfundidadeMaxima(getProfundidadeMaxima());
-   ag->setSelecao(getSelecao());
-   ag->setSelIndMutacao(getSelIndMutacao());
-   ag->setPercentMutacaoRecursiva(getPercentMutacaoRecursiva());
-   ag->setPercentReducao(getPercentReducao());
-   ag->setTime(sysTime1);
-   ag->exec(manipulado, tabConversao, melhor->get_extra());
-
-   VP_Entr_Rec += ag->getEntradaRec();
-	VP_Exec_Rec += ag->getExecRec();
-	VP_Comb_Rec += ag->getCombinaRec();
+   vector<int> rota;
+   if ((tarefa.cache)&&(tarefa.cache->busca(tabConversao->get_chave(), rota)))
+   {
+      //Problema já resolvido: usa a melhor rota conhecida, sem executar o AG
+      TIndividuo reduzido(getMapa(), tarefa.arqLog);
+      reduzido.novo(tabConversao->get_vetConv(), melhor->get_extra());
+      reduzido.set_rota(&rota[0]);
+      tabConversao->converte(manipulado, &reduzido);
+   }
+   else if ((tarefa.orcamento)&&(tarefa.orcamento->is_esgotado()))
+   {
+      //Sem orçamento o indivíduo fica como está
+      delete tabConversao;
+      return;
+   }
+   else
+   {
+      tarefa.execucoes++;
+      //Executando o AG recursivamente, sobre a matriz dos fragmentos. Além
+      //da profundidade máxima o AG não executa, e o mapa não é montado
+      TMapaGenes *mapaReduzido = (get_profundidade()+1<getProfundidadeMaxima())?tabConversao->get_mapaReduzido():getMapa();
+      TAlgGenetico *ag = new TAlgGenetico(mapaReduzido, tarefa.arqLog, get_profundidade()+1);
+      ag->setMutacao(getMutacao());
+      ag->setCruzamento(getCruzamento());
+      ag->setTamPopulacao(getTamPopulacao());
+      ag->setPrintParcial(getPrintParcial());
+      ag->setMaxGeracao(getMaxGeracao());
+      ag->setPercentElitismo(getPercentElitismo());
+      ag->setPercentMutacao(getPercentMutacao());
+      ag->setProfundidadeMaxima(getProfundidadeMaxima());
+      ag->setSelecao(getSelecao());
+      ag->setSelIndMutacao(getSelIndMutacao());
+      ag->setPercentMutacaoRecursiva(getPercentMutacaoRecursiva());
+      ag->setPercentReducao(getPercentReducao());
+      ag->setMinDoisNiveis(getMinDoisNiveis());
+      ag->setNumThreads(getNumThreads());
+      ag->setCacheReduzidos(tarefa.cache);
+      ag->setOrcamento(tarefa.orcamento);
+      ag->setTime(sysTime1);
+      ag->exec(manipulado, tabConversao, melhor->get_extra());
+
+      tarefa.entradas    += ag->getEntradaRec();
+      tarefa.execucoes   += ag->getExecRec();
+      tarefa.combinacoes += ag->getCombinaRec();
+      delete ag;
+   }
 
    if (manipulado->get_distancia()<melhor->get_distancia())
    {
-      populacao->troca(0, indice);
       string lin = "Melhorou profundidade ;";
 	  
 	  lin += to_string(get_profundidade()+1);
-	  if (getPrintParcial()) cout << endl << lin << endl;
-	  VP_ArqSaida->addLinha(lin);
+	  if (getPrintParcial())
+     {
+        #pragma omp critical (tela)
+        cout << endl << lin << endl;
+     }
+	  tarefa.arqLog->addLinha(lin);
    }
    else if (manipulado->get_distancia()==melhor->get_distancia())
    {
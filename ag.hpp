@@ -22,7 +22,23 @@
 #include "populacao.hpp"
 #include "utils.hpp"
 #include "tabconversao.hpp"
+#include "cachereduzidos.hpp"
+#include "orcamento.hpp"
 
+//Uma mutação recursiva de uma geração. As tarefas da geração são executadas em
+//paralelo, cada uma com o seu gerador, registro e cache, e os resultados são
+//incorporados na ordem do sorteio depois que todas terminam
+struct TTarefaRecursiva
+{
+   int indice;                //Indivíduo manipulado
+   uint64_t semente;
+   TArqLog *arqLog;           //Em memória
+   TCacheReduzidos *cache;    //Sobre o cache da geração, NULL sem cache
+   TOrcamento *orcamento;     //Sobre o orçamento da geração
+   unsigned entradas;
+   unsigned execucoes;
+   unsigned combinacoes;
+};
 
 class TAlgGenetico
 {
@@ -44,6 +60,12 @@ class TAlgGenetico
       int VP_percentReducao;
       int VP_profundidadeMaxima;
       int VP_percentMutacaoRecursiva;
+      int VP_rotaInicial;
+      int VP_minDoisNiveis;
+      int VP_tamCacheReduzidos;
+      int VP_numThreads;
+      int VP_tempoMaximo;
+      int VP_maxAvaliacoes;
 
       double VP_melhor_dist;
 	   int VP_melhor_gera;
@@ -51,6 +73,27 @@ class TAlgGenetico
       TMapaGenes *VP_Mapa;
       TArqLog *VP_ArqSaida;
 
+      //Indivíduos de todas as gerações desta execução
+      TPoolIndividuos *VP_pool;
+      //População vazia que recebe a próxima geração. Troca de
+      //papel com a população atual a cada iteração
+      TPopulacao *VP_reserva;
+      //Rotas dos problemas reduzidos já resolvidos. Criado pela execução
+      //principal e compartilhado com os AGs recursivos
+      TCacheReduzidos *VP_cache;
+      //Tabela que gerou o mapa deste AG recursivo, NULL na execução principal.
+      //Traduz as chaves do cache para as cidades da instância
+      TTabConversao *VP_tabNivel;
+      //Esforço da execução. Criado pela execução principal e compartilhado
+      //com os AGs recursivos, como o cache
+      TOrcamento *VP_orcamento;
+
+      //Média de filhos por cruzamento, para o tamanho das rodadas de geraDescendentes
+      double VP_filhosPorCruzamento;
+
+      //Threads das fases paralelas de uma geração
+      int get_qtdeThreads();
+
 		unsigned VP_Comb_Rec;
       unsigned VP_Entr_Rec;
 		unsigned VP_Exec_Rec;
@@ -84,6 +127,14 @@ class TAlgGenetico
       void setPercentReducao (int val);
 	   void setProfundidadeMaxima(int val);
       void setPercentMutacaoRecursiva (int val);
+      void setRotaInicial (int val);
+      void setMinDoisNiveis (int val);
+      void setTamCacheReduzidos (int val);
+      void setCacheReduzidos (TCacheReduzidos *cache);
+      void setNumThreads (int val);
+      void setTempoMaximo (int val);
+      void setMaxAvaliacoes (int val);
+      void setOrcamento (TOrcamento *orcamento);
 
       int getPercentReducao ();
 	   int getProfundidadeMaxima();
@@ -98,6 +149,12 @@ class TAlgGenetico
       int getPercentElitismo ();
       int getSelecao ();
       int getSelIndMutacao ();
+      int getRotaInicial ();
+      int getMinDoisNiveis ();
+      int getTamCacheReduzidos ();
+      int getNumThreads ();
+      int getTempoMaximo ();
+      int getMaxAvaliacoes ();
 
       void setTime (time_t sTime);
       //Métodos
@@ -112,7 +169,7 @@ class TAlgGenetico
       void elitismo(TPopulacao *novaPop, TPopulacao *populacao);
       void geraDescendentes(TPopulacao *novaPop, TPopulacao *populacao, int geracao);
       void fazMutacao(TPopulacao *populacao);
-      void mutacaoAGRecursivo(TPopulacao *populacao, int indice);
+      void mutacaoAGRecursivo(TTarefaRecursiva &tarefa, TIndividuo *melhor, TIndividuo *manipulado, int tamPopulacao);
 };
 
 #endif
@@ -15,10 +15,21 @@
 TArqLog::TArqLog(string cabecalho, string path)
 {
    VP_Path = path;
+   VP_memoria = false;
    fl.open (VP_Path, std::fstream::out);
    addLinha (cabecalho);
 }
 
+TArqLog::TArqLog()
+{
+   VP_memoria = true;
+}
+
+string TArqLog::get_texto ()
+{
+   return VP_texto;
+}
+
 TArqLog::~TArqLog()
 {
    fl.close();
@@ -26,10 +37,12 @@ TArqLog::~TArqLog()
 void TArqLog::addLinha (string linha)
 {
    addTexto(linha);
-   fl << endl;
+   if (VP_memoria) VP_texto += '\n';
+   else            fl << endl;
 }
 
 void TArqLog::addTexto (string texto)
 {
-   fl << texto;
+   if (VP_memoria) VP_texto += texto;
+   else            fl << texto;
 }
@@ -24,9 +24,15 @@ class TArqLog
    private:
       fstream fl;
       string VP_Path;
+      bool VP_memoria;
+      string VP_texto;
 
    public:
       TArqLog(string cabecalho, string path);
+      //Registro em memória, para as tarefas paralelas. O texto é
+      //copiado para o arquivo, na ordem das tarefas, no final
+      TArqLog();
+      string get_texto ();
       ~TArqLog();
       void addLinha (string linha);
       void addTexto (string texto);
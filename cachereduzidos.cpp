@@ -0,0 +1,137 @@
+/*
+*  cachereduzidos.cpp
+*
+*  Módulo responsável pelo cache das rotas dos indivíduos reduzidos do AG recursivo
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "cachereduzidos.hpp"
+
+TCacheReduzidos::TCacheReduzidos (unsigned capacidade, TCacheReduzidos *pai)
+{
+   VP_capacidade = (capacidade>0)?capacidade:1;
+   VP_pai = pai;
+   VP_acertos = 0;
+   VP_falhas = 0;
+}
+
+unsigned TCacheReduzidos::get_capacidade ()    { return VP_capacidade; }
+unsigned long TCacheReduzidos::get_acertos () { return VP_acertos; }
+unsigned long TCacheReduzidos::get_falhas ()  { return VP_falhas; }
+
+uint64_t TCacheReduzidos::hash (const vector<int> &chave)
+{
+   //FNV-1a, um inteiro por vez
+   uint64_t h = 14695981039346656037ULL;
+   for (unsigned i=0; i<chave.size(); i++)
+   {
+      h ^= (uint32_t) chave[i];
+      h *= 1099511628211ULL;
+   }
+   return h;
+}
+
+list<TCacheReduzidos::TEntrada>::iterator TCacheReduzidos::procura (const vector<int> &chave, uint64_t h)
+{
+   //Hashes iguais podem ser de chaves diferentes
+   auto faixa = VP_indice.equal_range(h);
+   for (auto i=faixa.first; i!=faixa.second; ++i)
+      if (i->second->chave==chave) return i->second;
+   return VP_entradas.end();
+}
+
+const TCacheReduzidos::TEntrada *TCacheReduzidos::procuraPai (const vector<int> &chave, uint64_t h) const
+{
+   for (const TCacheReduzidos *c=VP_pai; c; c=c->VP_pai)
+   {
+      auto faixa = c->VP_indice.equal_range(h);
+      for (auto i=faixa.first; i!=faixa.second; ++i)
+         if (i->second->chave==chave) return &*i->second;
+   }
+   return NULL;
+}
+
+bool TCacheReduzidos::busca (const vector<int> &chave, vector<int> &rota)
+{
+   uint64_t h = hash(chave);
+
+   list<TEntrada>::iterator entrada = procura(chave, h);
+   if (entrada==VP_entradas.end())
+   {
+      //No pai a entrada não muda de lugar, pois ele é só lido
+      const TEntrada *doPai = procuraPai(chave, h);
+      if (doPai)
+      {
+         rota = doPai->rota;
+         VP_acertos++;
+         return true;
+      }
+
+      VP_falhas++;
+      return false;
+   }
+
+   //Passa a ser a usada mais recentemente
+   VP_entradas.splice(VP_entradas.begin(), VP_entradas, entrada);
+   rota = entrada->rota;
+   VP_acertos++;
+   return true;
+}
+
+void TCacheReduzidos::guarda (const vector<int> &chave, const vector<int> &rota, double dist)
+{
+   vector<int> copia(chave);
+   insere(copia, rota, dist);
+}
+
+void TCacheReduzidos::insere (vector<int> &chave, const vector<int> &rota, double dist)
+{
+   uint64_t h = hash(chave);
+
+   list<TEntrada>::iterator entrada = procura(chave, h);
+   if (entrada!=VP_entradas.end())
+   {
+      if (dist<entrada->dist)
+      {
+         entrada->rota = rota;
+         entrada->dist = dist;
+      }
+      VP_entradas.splice(VP_entradas.begin(), VP_entradas, entrada);
+      return;
+   }
+
+   //Cheio: descarta a usada há mais tempo
+   if (VP_entradas.size()>=VP_capacidade)
+   {
+      TEntrada &antiga = VP_entradas.back();
+      auto faixa = VP_indice.equal_range(hash(antiga.chave));
+      for (auto i=faixa.first; i!=faixa.second; ++i)
+         if (&*i->second==&antiga)
+         {
+            VP_indice.erase(i);
+            break;
+         }
+      VP_entradas.pop_back();
+   }
+
+   VP_entradas.push_front(TEntrada());
+   VP_entradas.front().chave.swap(chave);
+   VP_entradas.front().rota = rota;
+   VP_entradas.front().dist = dist;
+   VP_indice.insert(make_pair(h, VP_entradas.begin()));
+}
+
+void TCacheReduzidos::incorpora (TCacheReduzidos &tarefa)
+{
+   //Da mais antiga para a mais recente, para manter a ordem de uso
+   for (list<TEntrada>::reverse_iterator i=tarefa.VP_entradas.rbegin(); i!=tarefa.VP_entradas.rend(); ++i)
+      insere(i->chave, i->rota, i->dist);
+
+   VP_acertos += tarefa.VP_acertos;
+   VP_falhas += tarefa.VP_falhas;
+}
@@ -0,0 +1,86 @@
+/*
+*  cachereduzidos.hpp
+*
+*  Módulo responsável pelo cache das rotas dos indivíduos reduzidos do AG recursivo
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _CACHEREDUZIDOS_H
+#define	_CACHEREDUZIDOS_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+#include <stdint.h>
+
+using namespace std;
+
+/*******************************************************
+classe de TCacheReduzidos. Guarda a melhor rota encontrada
+para cada problema reduzido da mutação recursiva. Com a
+população convergindo, a mesma tabela de conversão aparece
+muitas vezes, e o AG recursivo resolveria de novo o mesmo
+problema.
+
+O problema reduzido é definido pela sequência de fragmentos
+da tabela, cada um com a cidade de entrada e a de saída na
+instância (TTabConversao::get_chave). O interior dos
+fragmentos não muda a melhor ordem entre eles. A rota
+guardada é a ordem dos genes do indivíduo reduzido, e gene i
+é o fragmento i da tabela.
+
+Quando está cheio, descarta o problema usado há mais tempo.
+
+Nas tarefas paralelas cada tarefa tem o seu cache, sobre
+o cache da geração (pai). O pai só é lido durante as
+tarefas, e os caches das tarefas são incorporados a ele
+em ordem no final. Assim o resultado não depende da ordem
+em que as threads terminam.
+********************************************************/
+class TCacheReduzidos
+{
+   private:
+      struct TEntrada
+      {
+         vector<int> chave;      //Entrada e saída de cada fragmento
+         vector<int> rota;
+         double dist;
+      };
+
+      unsigned VP_capacidade;
+      TCacheReduzidos *VP_pai;     //Somente leitura, NULL no cache principal
+      unsigned long VP_acertos;
+      unsigned long VP_falhas;
+
+      //Da usada mais recentemente para a mais antiga
+      list<TEntrada> VP_entradas;
+      unordered_multimap<uint64_t, list<TEntrada>::iterator> VP_indice;
+
+      static uint64_t hash (const vector<int> &chave);
+      list<TEntrada>::iterator procura (const vector<int> &chave, uint64_t h);
+      //A chave é consumida
+      void insere (vector<int> &chave, const vector<int> &rota, double dist);
+      const TEntrada *procuraPai (const vector<int> &chave, uint64_t h) const;
+
+   public:
+      TCacheReduzidos (unsigned capacidade, TCacheReduzidos *pai = NULL);
+
+      unsigned get_capacidade ();
+      unsigned long get_acertos ();
+      unsigned long get_falhas ();
+
+      //Falso quando o problema não está no cache
+      bool busca (const vector<int> &chave, vector<int> &rota);
+      //Guarda a rota, ou troca a guardada se esta for menor
+      void guarda (const vector<int> &chave, const vector<int> &rota, double dist);
+      //Traz as entradas e contagens do cache de uma tarefa
+      void incorpora (TCacheReduzidos &tarefa);
+};
+
+#endif	/* _CACHEREDUZIDOS_H */
@@ -11,6 +11,7 @@
 */
 
 #include "config.hpp"
+#include <cstdlib>
 
 void TConfig::leInfo(xmlDocPtr doc, xmlNode * a_node)
 {
@@ -40,6 +41,17 @@ void TConfig::leInfo(xmlDocPtr doc, xmlNode * a_node)
          else if (!xmlStrcmp(cur_node->name, (xmlChar *)"selecao")) selecao = val;
          else if (!xmlStrcmp(cur_node->name, (xmlChar *)"selIndMutacao")) selIndMutacao = val;
 		   else if (!xmlStrcmp(cur_node->name, (xmlChar *)"profundidadeMaxima")) profundidadeMaxima = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"armazenamentoDist")) armazenamento = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"cacheInstancia")) cacheInstancia = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"qtdeCandidatos")) qtdeCandidatos = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"candidatosQuadrante")) candidatosQuadrante = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"rotaInicial")) rotaInicial = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"renumeracao")) renumeracao = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"minDoisNiveis")) minDoisNiveis = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"tamCacheReduzidos")) tamCacheReduzidos = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"numThreads")) numThreads = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"tempoMaximo")) tempoMaximo = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"maxAvaliacoes")) maxAvaliacoes = val;
 
       }
 
@@ -64,6 +76,17 @@ TConfig::TConfig()
    percentElitismo = 70;
    profundidadeMaxima = 5;
 	selecao = 0;
+   armazenamento = 0;
+   cacheInstancia = 1;
+   qtdeCandidatos = 10;
+   candidatosQuadrante = 0;
+   rotaInicial = 0;
+   renumeracao = 0;
+   minDoisNiveis = 10000;
+   tamCacheReduzidos = 1000;
+   numThreads = 0;
+   tempoMaximo = 0;
+   maxAvaliacoes = 0;
 }
 
 void TConfig::carregaDoArquivo(char *nomeArquivo)
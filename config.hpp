@@ -49,6 +49,19 @@ class TConfig
                                    //  0 - o melhor individuo nunca é selecionado
                                    //  1 - o melhor individuo sempre é seleconado
                                    //  2 - seleção do melhor individuo é aleatória
+      int armazenamento;           //Armazenamento da tabela de distâncias
+                                   //  0 - automático, 1 - double, 2 - float,
+                                   //  3 - int32, 4 - uint16
+      int cacheInstancia;          //Grava e reutiliza o cache binário da instância
+      int qtdeCandidatos;          //Vizinhos mais próximos na lista de candidatos de cada cidade
+      int candidatosQuadrante;     //Vizinhos garantidos por quadrante (instâncias com coordenadas)
+      int rotaInicial;             //0 - população aleatória, 1 - inclui a rota do vizinho mais próximo
+      int renumeracao;             //0 - mantém os números da instância, 1 - renumera as cidades por proximidade
+      int minDoisNiveis;           //Cidades a partir das quais o 2-opt com candidatos usa a lista de dois níveis, 0 desliga
+      int tamCacheReduzidos;       //Problemas reduzidos guardados com a melhor rota encontrada, 0 desliga
+      int numThreads;              //Threads das mutações recursivas, 0 usa todos os núcleos
+      int tempoMaximo;             //Limite da execução em segundos, 0 sem limite
+      int maxAvaliacoes;           //Limite da execução em milhares de avaliações, 0 sem limite
 
       /*******************************************************
            Os valores padrões são os utilizados no artigo
@@ -136,7 +136,7 @@ vector <TIndividuo *>TCruzamento::GSTX(TIndividuo *parceiro1, TIndividuo *parcei
    vector<TGene *> temp;
    vector<bool> controle (parceiro1->get_qtdeGenes(), true);
 
-   TIndividuo *filho = new TIndividuo(VP_Mapa, VP_ArqSaida);
+   TIndividuo *filho = TPoolIndividuos::aloca(parceiro1->get_pool(), VP_Mapa, VP_ArqSaida);
 
    int pivo =  TUtils::rnd(1, parceiro1->get_qtdeGenes()-1);
    gPar1 = parceiro1->get_por_indice(pivo);
@@ -168,7 +168,7 @@ vector <TIndividuo *>TCruzamento::GSTX(TIndividuo *parceiro1, TIndividuo *parcei
 
       if (dir)
       {
-         if (gPar2->prox->id==0) dir = false;
+         if (parceiro2->prox(gPar2)->id==0) dir = false;
          else
          {
             gPar2 = parceiro2->prox(gPar2);
@@ -293,9 +293,10 @@ vector <TIndividuo *>TCruzamento::OX1(TIndividuo *parceiro1, TIndividuo *parceir
 			
 			it2 = parceiro2->get_por_indice(j);
 			it1 = filho1->get_por_id(it2->id);
-			if(it1->i<uInicio || it1->i>uFin) //Não está entre uInicio e uFin
+			int pos1 = filho1->get_indice(it1);
+			if(pos1<uInicio || pos1>uFin) //Não está entre uInicio e uFin
          {
-				filho1->troca_indice(i, it1->i);
+				filho1->troca_indice(i, pos1);
 				break;
          }
 		}
@@ -324,9 +325,10 @@ vector <TIndividuo *>TCruzamento::OX1(TIndividuo *parceiro1, TIndividuo *parceir
 			
 			it1 = parceiro1->get_por_indice(j);
 			it2 = filho2->get_por_id(it1->id);
-			if(it2->i<uInicio || it2->i>uFin) //Não está entre uInicio e uFin
+			int pos2 = filho2->get_indice(it2);
+			if(pos2<uInicio || pos2>uFin) //Não está entre uInicio e uFin
          {
-				filho2->troca_indice(i, it2->i);
+				filho2->troca_indice(i, pos2);
 				break;
          }
 		}
@@ -377,7 +379,7 @@ vector <TIndividuo *>TCruzamento::OX2(TIndividuo *parceiro1, TIndividuo *parceir
 		//Buscando a mesma cidade no Parceiro 2
 		tmp = parceiro2->get_por_id(tmp->id);
 		//Guardando a posição da cidade no Parceiro 2
-		pPar2.insert(tmp->i);		
+		pPar2.insert(parceiro2->get_indice(tmp));		
 	}
 
    TGene *g1;
@@ -440,9 +442,9 @@ vector <TIndividuo *>TCruzamento::MOX(TIndividuo *parceiro1, TIndividuo *parceir
 		
 		//Se a cidade estiver fora da parte imutável do filho
 		//passa a fazer parte do filho na mesma sequência do parceiro 2
-		if(tmp->i >= point)
+		if(filho1->get_indice(tmp) >= point)
 		{
-			filho1->troca_indice(k, tmp->i);
+			filho1->troca_indice(k, filho1->get_indice(tmp));
 			k++;
 		}
 	}
@@ -499,7 +501,7 @@ vector <TIndividuo *>TCruzamento::POS(TIndividuo *parceiro1, TIndividuo *parceir
 
       //Se g2 é fixado no filho guardo sua posição	Parceiro 1
 		g1 = parceiro1->get_por_id(g2->id);
-		pPar2.insert(g1->i);
+		pPar2.insert(parceiro1->get_indice(g1));
 	}
 	
 	//ajustando a ordem dos genes não fixados que devem
@@ -561,7 +563,7 @@ vector <TIndividuo *>TCruzamento::CX(TIndividuo *parceiro1, TIndividuo *parceiro
 	{
 	   filho1->troca (g1->id, g2->id);
 		filho2->troca (g1->id, g2->id);
-		g2 = parceiro2->get_por_indice(g1->i);
+		g2 = parceiro2->get_por_indice(filho1->get_indice(g1));
 	}
 		
 	return filhos;
@@ -601,7 +603,7 @@ vector <TIndividuo *>TCruzamento::DPX(TIndividuo *parceiro1, TIndividuo *parceir
 			primeiro = false;
 		}
 		
-		if ((g1->prox->id != g2->prox->id)||(g1->prox->id==0))
+		if ((filho1->prox(g1)->id != parceiro2->prox(g2)->id)||(filho1->prox(g1)->id==0))
       {
 			fragmentoFim.push_back(g1);
          primeiro = true;
@@ -646,12 +648,12 @@ vector <TIndividuo *>TCruzamento::DPX(TIndividuo *parceiro1, TIndividuo *parceir
 		g1 = fragmentoFim[0];
 		g2 = fragmentoIni[proxFragmento];
 		
-		int ini1 = g1->i + 1;
+		int ini1 = filho1->get_indice(g1) + 1;
 		int tam1 = 0;
-		int ini2 = g2->i;
+		int ini2 = filho1->get_indice(g2);
 		
 		g2 = fragmentoFim[proxFragmento];		
-		int tam2 = g2->i - ini2 + 1;
+		int tam2 = filho1->get_indice(g2) - ini2 + 1;
 
       if(inverte) tam2 *= -1;
 		
@@ -706,10 +708,10 @@ vector <TIndividuo *>TCruzamento::AP(TIndividuo *parceiro1, TIndividuo *parceiro
 			tmp = filho1->get_por_id(tmp->id);
 
 			//Verificando se o Gene já foi incluido
-			if (tmp->i == iFilho1) iFilho1++; //Ja está na posição
-      	else if (tmp->i > iFilho1) //Ainda não está na posição correta
+			if (filho1->get_indice(tmp) == iFilho1) iFilho1++; //Ja está na posição
+      	else if (filho1->get_indice(tmp) > iFilho1) //Ainda não está na posição correta
 			{
-				filho1->troca_indice(iFilho1, tmp->i);
+				filho1->troca_indice(iFilho1, filho1->get_indice(tmp));
 				iFilho1++;
 			}
 			
@@ -724,10 +726,10 @@ vector <TIndividuo *>TCruzamento::AP(TIndividuo *parceiro1, TIndividuo *parceiro
 			tmp = filho1->get_por_id(tmp->id);
 			
 			//Verificando se o Gene já foi incluido
-			if (tmp->i == iFilho1) iFilho1++; //Ja está na posição
-      	else if (tmp->i > iFilho1) //Ainda não está na posição correta
+			if (filho1->get_indice(tmp) == iFilho1) iFilho1++; //Ja está na posição
+      	else if (filho1->get_indice(tmp) > iFilho1) //Ainda não está na posição correta
 			{
-				filho1->troca_indice(iFilho1, tmp->i);
+				filho1->troca_indice(iFilho1, filho1->get_indice(tmp));
 				iFilho1++;
 			}
 			
@@ -749,10 +751,10 @@ vector <TIndividuo *>TCruzamento::AP(TIndividuo *parceiro1, TIndividuo *parceiro
 			tmp = filho2->get_por_id(tmp->id);
 			
 			//Verificando se o Gene já foi incluido
-			if (tmp->i == iFilho2) iFilho2++; //Ja está na posição
-      	else if (tmp->i > iFilho2) //Ainda não está na posição correta
+			if (filho2->get_indice(tmp) == iFilho2) iFilho2++; //Ja está na posição
+      	else if (filho2->get_indice(tmp) > iFilho2) //Ainda não está na posição correta
 			{
-				filho2->troca_indice(iFilho2, tmp->i);
+				filho2->troca_indice(iFilho2, filho2->get_indice(tmp));
 				iFilho2++;
 			}
 			
@@ -767,10 +769,10 @@ vector <TIndividuo *>TCruzamento::AP(TIndividuo *parceiro1, TIndividuo *parceiro
 			tmp = filho2->get_por_id(tmp->id);
 			
 			//Verificando se o Gene já foi incluido
-			if (tmp->i == iFilho2) iFilho2++; //Ja está na posição
-      	else if (tmp->i > iFilho2) //Ainda não está na posição correta
+			if (filho2->get_indice(tmp) == iFilho2) iFilho2++; //Ja está na posição
+      	else if (filho2->get_indice(tmp) > iFilho2) //Ainda não está na posição correta
 			{
-				filho2->troca_indice(iFilho2, tmp->i);
+				filho2->troca_indice(iFilho2, filho2->get_indice(tmp));
 				iFilho2++;
 			}
 			
@@ -827,7 +829,7 @@ vector <TIndividuo *>TCruzamento::MPX(TIndividuo *parceiro1, TIndividuo *parceir
 			tmp = parceiro2->get_por_indice(begin);
 			//Pegando o gene no filho
 			tmp = filho1->get_por_id(tmp->id);
-			filho1->troca_indice(i, tmp->i);
+			filho1->troca_indice(i, filho1->get_indice(tmp));
 			begin++;
 		}
 		else  //pós preecher o início
@@ -844,12 +846,12 @@ vector <TIndividuo *>TCruzamento::MPX(TIndividuo *parceiro1, TIndividuo *parceir
 				
 				//Verficando se já está na posição correta, no filho
 				tmp = filho1->get_por_id(tmp->id);
-			}while (tmp->i < i);
+			}while (filho1->get_indice(tmp) < i);
 			
 			//Não tem mais nada para ser posicionado
 			if (index >= parceiro1->get_qtdeGenes()) break;
 
-			filho1->troca_indice(i, tmp->i);
+			filho1->troca_indice(i, filho1->get_indice(tmp));
 		}		
 	}
 	
@@ -898,10 +900,10 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
       //Verificando os vizinhos do gene em parente 1
 		
 		//se ainda não foi posicionado	
-      gTmp = filho1->get_por_id(found->prox->id);	
-		if ((gTmp->i > ini && gTmp->i < fim) || (gTmp->i==0 && fim == filho1->get_qtdeGenes()))
+      gTmp = filho1->get_por_id(parceiro1->prox(found)->id);	
+		if ((filho1->get_indice(gTmp) > ini && filho1->get_indice(gTmp) < fim) || (filho1->get_indice(gTmp)==0 && fim == filho1->get_qtdeGenes()))
 		{
-		   custo = VP_Mapa->get_distancia(found->ori, found->prox->dest);
+		   custo = VP_Mapa->get_distancia(found->ori, parceiro1->prox(found)->dest);
 			if (custo < min)
 			{
 				min = custo;
@@ -910,10 +912,10 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
 		}
 		
 		//se ainda não foi posicionado		
-      gTmp = filho1->get_por_id(found->ant->id);
-		if ((gTmp->i > ini && gTmp->i < fim) || (gTmp->i==0 && fim == filho1->get_qtdeGenes()))
+      gTmp = filho1->get_por_id(parceiro1->ant(found)->id);
+		if ((filho1->get_indice(gTmp) > ini && filho1->get_indice(gTmp) < fim) || (filho1->get_indice(gTmp)==0 && fim == filho1->get_qtdeGenes()))
 		{
-		   custo = VP_Mapa->get_distancia(found->ori, found->ant->dest);
+		   custo = VP_Mapa->get_distancia(found->ori, parceiro1->ant(found)->dest);
 			if (custo < min)
 			{
 				min = custo;
@@ -925,10 +927,10 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
 		found = parceiro2->get_por_id(g->id);
 			
 		//se ainda não foi posicionado		
-      gTmp = filho1->get_por_id(found->prox->id);
-		if ((gTmp->i > ini && gTmp->i < fim) || (gTmp->i==0 && fim == filho1->get_qtdeGenes()))
+      gTmp = filho1->get_por_id(parceiro2->prox(found)->id);
+		if ((filho1->get_indice(gTmp) > ini && filho1->get_indice(gTmp) < fim) || (filho1->get_indice(gTmp)==0 && fim == filho1->get_qtdeGenes()))
 		{
-		   custo = VP_Mapa->get_distancia(found->ori, found->prox->dest);
+		   custo = VP_Mapa->get_distancia(found->ori, parceiro2->prox(found)->dest);
 			if (custo < min)
 			{
 				min = custo;
@@ -937,10 +939,10 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
 		}
 
 		//se ainda não foi posicionado		
-      gTmp = filho1->get_por_id(found->ant->id);	
-		if ((gTmp->i > ini && gTmp->i < fim) || (gTmp->i==0 && fim == filho1->get_qtdeGenes()))
+      gTmp = filho1->get_por_id(parceiro2->ant(found)->id);	
+		if ((filho1->get_indice(gTmp) > ini && filho1->get_indice(gTmp) < fim) || (filho1->get_indice(gTmp)==0 && fim == filho1->get_qtdeGenes()))
 		{
-		   custo = VP_Mapa->get_distancia(found->ori, found->ant->dest);     		
+		   custo = VP_Mapa->get_distancia(found->ori, parceiro2->ant(found)->dest);     		
 			if (custo < min)
 			{
 				min = custo;
@@ -959,19 +961,19 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
 		if (proxG->id == 0)
 		{
 			//Movo todo o bloco que já fo montado para o fim
-			i = g->i;
-			filho1->troca_sub(1, g->i, fim, 0);
+			i = filho1->get_indice(g);
+			filho1->troca_sub(1, filho1->get_indice(g), fim, 0);
 			fim = fim - i;
 			g = filho1->get_ini();
 		}
 		else
 		{
-			filho1->troca(g->prox->id, proxG->id);
-   		g = g->prox;
+			filho1->troca(filho1->prox(g)->id, proxG->id);
+   		g = filho1->prox(g);
 		}
 		
 		found = parceiro1->get_por_id(g->id);
-		ini = g->i;
+		ini = filho1->get_indice(g);
 	}
 
 	return filhos;
@@ -1015,26 +1017,25 @@ vector <TIndividuo *>TCruzamento::IO(TIndividuo *parceiro1, TPopulacao *populaca
 			j = TUtils::rnd(0, populacao->get_qtdeIndividuo()-1);
 			TIndividuo *indSelect = populacao->get_individuo(j);
 			c_prim = indSelect->get_por_id(c->id);
-			c_prim = c_prim->prox;
+			c_prim = indSelect->prox(c_prim);
          c_prim = filho1->get_por_id(c_prim->id);
-			j = c_prim->i;
+			j = filho1->get_indice(c_prim);
 		}
 		
-		if ((c->prox->i == c_prim->i) || (c->ant->i == c_prim->i))
+		if ((filho1->prox(c)->id == c_prim->id) || (filho1->ant(c)->id == c_prim->id))
 			break;
 
       
-		if(i > j) filho1->inverte_sub(c->ant, c_prim);
-      else      filho1->inverte_sub(c->prox, c_prim);
+		if(i > j) filho1->inverte_sub(filho1->ant(c), c_prim);
+      else      filho1->inverte_sub(filho1->prox(c), c_prim);
       
 		c = c_prim;
-		i = c->i;
+		i = filho1->get_indice(c);
 	}
 	
 	if(parceiro1->get_distancia() < filho1->get_distancia())
 	{
-		delete filho1;
-		filho1 = parceiro1->clona();		
+		filho1->copyFrom(*parceiro1);
 	}
 	
 	filhos.push_back(filho1);
@@ -1068,34 +1069,40 @@ vector <TIndividuo *>TCruzamento::MIO (TIndividuo *parceiro1, TPopulacao *popula
 	{
 		if(TUtils::flip(Prd))
 		{
-			vector<pair <int, double> > custos;
-			for (int ii=1; ii<filho1->get_qtdeGenes(); ii++)
+			if (sorteiaCandidato(filho1, c, qtdeMelhores, c_prim))
 			{
-				if (ii==c->i) continue;
-				c_prim = filho1->get_por_indice(ii);
-				VP_Mapa->get_distancia(c->ori, c_prim->dest);
-				pair <int, double> custo (ii, VP_Mapa->get_distancia(c->ori, c_prim->dest));
-				custos.push_back(custo);					
-			}		
-			sort (custos.begin(), custos.end(), compare_pair_second<std::less>());
-							 
-			j = TUtils::rnd(0, (custos.size()>qtdeMelhores)?qtdeMelhores-1:custos.size()-1);
-			j = custos[j].first;
-			c_prim = filho1->get_por_indice(j);
-			
-			custos.clear();
+				j = filho1->get_indice(c_prim);
+			}
+			else
+			{
+				vector<pair <int, double> > custos;
+				for (int ii=1; ii<filho1->get_qtdeGenes(); ii++)
+				{
+					if (ii==filho1->get_indice(c)) continue;
+					c_prim = filho1->get_por_indice(ii);
+					pair <int, double> custo (ii, VP_Mapa->get_distancia(c->ori, c_prim->dest));
+					custos.push_back(custo);
+				}
+				sort (custos.begin(), custos.end(), compare_pair_second<std::less>());
+
+				j = TUtils::rnd(0, (custos.size()>qtdeMelhores)?qtdeMelhores-1:custos.size()-1);
+				j = custos[j].first;
+				c_prim = filho1->get_por_indice(j);
+
+				custos.clear();
+			}
 		}
 		else
 		{
 			j = TUtils::rnd(0, populacao->get_qtdeIndividuo()-1);
 			TIndividuo *indSelect = populacao->get_individuo(j);
 			c_prim = indSelect->get_por_id(c->id);
-			c_prim = c_prim->prox;
+			c_prim = indSelect->prox(c_prim);
          c_prim = filho1->get_por_id(c_prim->id);
-			j = c_prim->i;
+			j = filho1->get_indice(c_prim);
 		}
 		
-		if ((c->prox->i == c_prim->i) || (c->ant->i == c_prim->i))
+		if ((filho1->prox(c)->id == c_prim->id) || (filho1->ant(c)->id == c_prim->id))
 			break;
 
       
@@ -1112,7 +1119,7 @@ vector <TIndividuo *>TCruzamento::MIO (TIndividuo *parceiro1, TPopulacao *popula
 			}
 		}
       else      
-			filho1->inverte_sub(c->prox, c_prim);
+			filho1->inverte_sub(filho1->prox(c), c_prim);
 
       Puc = PUCmax * exp((log(PUCmin / PUCmax)/maxGeracao)*geracao);
       if(TUtils::flip(Puc))
@@ -1120,19 +1127,46 @@ vector <TIndividuo *>TCruzamento::MIO (TIndividuo *parceiro1, TPopulacao *popula
 			c = c_prim;
       }
 		
-		i = c->i;
+		i = filho1->get_indice(c);
 	}
 	
 	if(parceiro1->get_distancia() < filho1->get_distancia())
 	{
-		delete filho1;
-		filho1 = parceiro1->clona();		
+		filho1->copyFrom(*parceiro1);
 	}
 	
 	filhos.push_back(filho1);
 	return filhos;
 }
 
+/**
+ *
+ * Escolhe, entre os qtdeMelhores genes mais próximos de c, um gene ao acaso,
+ * usando as listas de candidatos do mapa em vez de ordenar todos os custos.
+ * Considera os mesmos genes da busca completa (todos, menos o 0 e o próprio
+ * c). Retorna falso quando as listas não existem, não se aplicam ao
+ * indivíduo (genes que não são as cidades do mapa) ou são curtas demais.
+ *
+ **/
+bool TCruzamento::sorteiaCandidato (TIndividuo *individuo, TGene *c, unsigned qtdeMelhores, TGene *&escolhido)
+{
+	int qtdeCandidatos = VP_Mapa->get_qtdeCandidatos();
+	if ((qtdeCandidatos==0)||(!individuo->is_completo())||(individuo->get_qtdeGenes()<3)) return false;
+
+	unsigned disponiveis = individuo->get_qtdeGenes() - 2;
+	unsigned qtde = (disponiveis<qtdeMelhores)?disponiveis:qtdeMelhores;
+	const int *candidatos = VP_Mapa->get_candidatos(c->ori);
+	vector<int> melhores;
+
+	for (int k=0; (k<qtdeCandidatos)&&(melhores.size()<qtde); k++)
+		if ((candidatos[k]!=0)&&(candidatos[k]!=c->id)) melhores.push_back(candidatos[k]);
+
+	if (melhores.size()<qtde) return false;
+
+	escolhido = individuo->get_por_id(melhores[TUtils::rnd(0, qtde-1)]);
+	return true;
+}
+
 /**
  *
  * Voting Recombination Crossover (VR)
@@ -1236,8 +1270,8 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 		g = filho1->get_por_indice(i);
 		
 		//Servirá como a parte aleatória a medida que as posições	
-		custoMelhor = VP_Mapa->get_distancia(g->ori, g->prox->dest);
-      idMelhor = g->prox->id;
+		custoMelhor = VP_Mapa->get_distancia(g->ori, filho1->prox(g)->dest);
+      idMelhor = filho1->prox(g)->id;
       
 		//########################
 		// Parceiro 1
@@ -1247,8 +1281,8 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 		
 		//Verificando se o próximo já está no filho
 		//*****************************************
-		gVizinho = filho1->get_por_id(gTemp->prox->id);
-		if (gVizinho->i > i) //ainda não faz parte do filho
+		gVizinho = filho1->get_por_id(parceiro1->prox(gTemp)->id);
+		if (filho1->get_indice(gVizinho) > i) //ainda não faz parte do filho
 		{
 			//Verifico o custo
 			custoTemp = VP_Mapa->get_distancia(g->ori, gVizinho->dest);
@@ -1262,8 +1296,8 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 
 		//Verificando se o anterior já está no filho
 		//*******************************************
-		gVizinho = filho1->get_por_id(gTemp->ant->id);
-		if (gVizinho->i > i) //ainda não faz parte do filho
+		gVizinho = filho1->get_por_id(parceiro1->ant(gTemp)->id);
+		if (filho1->get_indice(gVizinho) > i) //ainda não faz parte do filho
 		{
 			//Verifico o custo
 			custoTemp = VP_Mapa->get_distancia(g->ori, gVizinho->dest);
@@ -1283,8 +1317,8 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 		
 		//Verificando se o próximo já está no filho
 		//*****************************************
-		gVizinho = filho1->get_por_id(gTemp->prox->id);
-		if (gVizinho->i > i) //ainda não faz parte do filho
+		gVizinho = filho1->get_por_id(parceiro2->prox(gTemp)->id);
+		if (filho1->get_indice(gVizinho) > i) //ainda não faz parte do filho
 		{
 			//Verifico o custo
 			custoTemp = VP_Mapa->get_distancia(g->ori, gVizinho->dest);
@@ -1298,8 +1332,8 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 
 		//Verificando se o anterior já está no filho
 		//*******************************************
-		gVizinho = filho1->get_por_id(gTemp->ant->id);
-		if (gVizinho->i > i) //ainda não faz parte do filho
+		gVizinho = filho1->get_por_id(parceiro2->ant(gTemp)->id);
+		if (filho1->get_indice(gVizinho) > i) //ainda não faz parte do filho
 		{
 			//Verifico o custo
 			custoTemp = VP_Mapa->get_distancia(g->ori, gVizinho->dest);
@@ -1311,7 +1345,7 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 			}
 		}
 
-	   filho1->troca (g->prox->id, idMelhor);		
+	   filho1->troca (filho1->prox(g)->id, idMelhor);		
 	}
 
 	filhos.push_back(filho1);
@@ -63,5 +63,8 @@ class TCruzamento
 		vector <TIndividuo *>MIO  (TIndividuo *parceiro1, TPopulacao *populacao, int maxGeracao, int geracao);
 		vector <TIndividuo *>VR   (TIndividuo *parceiro1, TIndividuo *parceiro2, TPopulacao *populacao);
 		vector <TIndividuo *>ER   (TIndividuo *parceiro1, TIndividuo *parceiro2);
+
+      //Sorteia um dos qtdeMelhores genes mais próximos de c pelas listas de candidatos
+      bool sorteiaCandidato (TIndividuo *individuo, TGene *c, unsigned qtdeMelhores, TGene *&escolhido);
 };
 #endif
@@ -11,11 +11,15 @@
 */
 
 #include "individuo.hpp"
+#include "poolindividuos.hpp"
 #include <iostream>
+#include <algorithm>
+#include <limits>
 
 //Apenas letura
 TMapaGenes *TIndividuo::getMapa() { return VP_Mapa; }
 TArqLog *TIndividuo::getArqLog()  { return VP_ArqSaida; }
+TPoolIndividuos *TIndividuo::get_pool() { return VP_pool; }
 
 int TIndividuo::get_extra ()         { return VP_Extra; }
 void TIndividuo::set_extra (int val) { VP_Extra = val; }
@@ -23,151 +27,202 @@ void TIndividuo::set_extra (int val) { VP_Extra = val; }
 double TIndividuo::get_distancia()    { return VP_dist; }
 double TIndividuo::get_distanciaInv() { return VP_distInv; }
 
-TGene *TIndividuo::get_ini () { return VP_indice[0]; }
-TGene *TIndividuo::get_por_indice (int indice) { return VP_indice[indice]; }
-TGene *TIndividuo::get_por_id (int id) { return VP_direto[id]; }
-
-int TIndividuo::ind_prox(int ind) { return (ind<(VP_qtdeGenes-1))?ind+1:0; }
-TGene *TIndividuo::prox (TGene *gene) { return gene->prox; }
-TGene *TIndividuo::prox (int idG) { return VP_direto[idG]->prox; }
-
-int TIndividuo::ind_ant(int ind) { return (ind>0)?ind-1:(VP_qtdeGenes-1); }
-TGene *TIndividuo::ant (TGene *gene) { return gene->ant; }
-TGene *TIndividuo::ant (int idG) { return VP_direto[idG]->ant; }
-
 int TIndividuo::get_qtdeGenes() { return VP_qtdeGenes; }
 
+bool TIndividuo::is_simetrico() { return VP_simples && VP_Mapa->is_simetrico(); }
+bool TIndividuo::is_completo()  { return VP_completo; }
+
 //Métodos
-TIndividuo::TIndividuo (TMapaGenes *mapa, TArqLog *arqSaida)
+TIndividuo::TIndividuo (TMapaGenes *mapa, TArqLog *arqSaida, TPoolIndividuos *pool)
 {
    VP_Mapa = mapa;
    VP_ArqSaida = arqSaida;
+   VP_pool = pool;
 
    VP_Extra = 0;
    VP_dist = 0;
 	VP_distInv = 0;
-   VP_qtdeGeneAlloc = 0;
+   VP_qtdeGenes = 0;
+   VP_tabela = NULL;
+   VP_simples = true;
+   VP_completo = false;
+}
+
+TIndividuo::TIndividuo (const TIndividuo &origem)
+{
+   VP_pool = NULL;
+   copyFrom(origem);
+}
+
+TIndividuo::TIndividuo (TIndividuo &&origem) noexcept
+{
+   VP_pool = NULL;
+   *this = std::move(origem);
+}
+
+TIndividuo &TIndividuo::operator= (const TIndividuo &origem)
+{
+   if (this != &origem) copyFrom(origem);
+   return *this;
+}
+
+TIndividuo &TIndividuo::operator= (TIndividuo &&origem) noexcept
+{
+   if (this == &origem) return *this;
+
+   VP_Mapa = origem.VP_Mapa;
+   VP_ArqSaida = origem.VP_ArqSaida;
+   VP_genes = std::move(origem.VP_genes);
+   VP_tabela = origem.VP_tabela;
+   VP_ordem = std::move(origem.VP_ordem);
+   VP_posicao = std::move(origem.VP_posicao);
+   VP_qtdeGenes = origem.VP_qtdeGenes;
+   VP_simples = origem.VP_simples;
+   VP_completo = origem.VP_completo;
+   VP_dist = origem.VP_dist;
+   VP_distInv = origem.VP_distInv;
+   VP_Extra = origem.VP_Extra;
+
+   //A origem fica sem rota
+   origem.VP_tabela = NULL;
+   origem.VP_ordem.clear();
+   origem.VP_posicao.clear();
+   origem.VP_qtdeGenes = 0;
+   origem.VP_dist = 0;
+   origem.VP_distInv = 0;
+   return *this;
 }
 
+//A tabela de genes é liberada pelo último indivíduo que a usa
 TIndividuo::~TIndividuo()
 {
-   for (vector< TGene *>::iterator i=VP_indice.begin(); i!=VP_indice.end(); ++i)
-   {
-     delete (*i);
-   }
-   VP_indice.clear();
-   VP_direto.clear();
+}
+
+void TIndividuo::alocaGenes (int qtde)
+{
+   VP_qtdeGenes = qtde;
+   VP_genes = make_shared< vector<TGene> > (qtde);
+   VP_tabela = VP_genes->data();
+   VP_ordem.resize (qtde);
+   VP_posicao.resize (qtde);
+   VP_dist = 0;
 }
 
 //Cria um novo indivíduo
 void TIndividuo::novo ()
 {
-   TGene *gene;
-   VP_qtdeGenes = VP_Mapa->get_qtdeGenes();
-   VP_dist = 0;
+   alocaGenes (VP_Mapa->get_qtdeGenes());
 
    for (int i=0; i<VP_qtdeGenes; i++)
    {
-      gene = new TGene;
-      gene->id   = i;
-      gene->ori  = i;
-      gene->dest = i;
-      gene->i    = i;
-      VP_direto.push_back (gene);
-      VP_indice.push_back (gene);
-      if (i==0) continue;
-      VP_direto[i]->ant = VP_direto[i-1];
-      VP_direto[i-1]->prox = VP_direto[i];
-      VP_dist += VP_Mapa->get_distancia(VP_direto[i-1]->ori, VP_direto[i]->dest);
+      VP_tabela[i].id   = i;
+      VP_tabela[i].ori  = i;
+      VP_tabela[i].dest = i;
+      VP_ordem[i] = i;
+      VP_posicao[i] = i;
    }
-   //Fechando o ciclo
-   VP_direto[VP_qtdeGenes-1]->prox = VP_direto[0];
-   VP_direto[0]->ant = VP_direto[VP_qtdeGenes-1];
 
    //Se o indivíduo foi modificado, o 2opt deve começar do início
    VP_Extra = 0;
 
-   VP_dist += VP_Mapa->get_distancia(VP_direto[VP_qtdeGenes-1]->ori, VP_direto[0]->dest);
-	VP_distInv = 1/VP_dist;
+   VP_simples = true;
+   VP_completo = true;
+   recalcDist();
 }
 
-void TIndividuo::novo (vector<TTipoConversao> genes, int extraPadrao)
+//Cria um novo indivíduo na ordem de uma rota do mapa
+void TIndividuo::novo (const int *rota)
 {
-   TGene *gene;
-   VP_qtdeGenes = genes.size();
-   VP_dist = 0;
+   alocaGenes (VP_Mapa->get_qtdeGenes());
 
    for (int i=0; i<VP_qtdeGenes; i++)
    {
-      gene = new TGene;
-      gene->id   = i;
-      gene->ori  = genes[i].ulOrig;
-      gene->dest = genes[i].prDest;
-      gene->i    = i;
+      VP_tabela[i].id   = i;
+      VP_tabela[i].ori  = i;
+      VP_tabela[i].dest = i;
+      VP_ordem[i] = rota[i];
+      VP_posicao[rota[i]] = i;
+   }
 
-      VP_direto.push_back (gene);
-      VP_indice.push_back (gene);
+   //Se o indivíduo foi modificado, o 2opt deve começar do início
+   VP_Extra = 0;
 
-      if (i==0) continue;
-      VP_indice[i]->ant = VP_indice[i-1];
-      VP_indice[i-1]->prox = VP_indice[i];
+   VP_simples = true;
+   VP_completo = true;
+   recalcDist();
+}
 
-      VP_dist += VP_Mapa->get_distancia(VP_indice[i-1]->ori, VP_indice[i]->dest);
+void TIndividuo::set_rota (const int *rota)
+{
+   for (int i=0; i<VP_qtdeGenes; i++)
+   {
+      VP_ordem[i] = rota[i];
+      VP_posicao[rota[i]] = i;
    }
+   recalcDist();
+}
 
-   //Fechando o ciclo
-   VP_indice[VP_qtdeGenes-1]->prox = VP_indice[0];
-   VP_indice[0]->ant = VP_indice[VP_qtdeGenes-1];
+void TIndividuo::novo (vector<TTipoConversao> genes, int extraPadrao)
+{
+   alocaGenes (genes.size());
+
+   for (int i=0; i<VP_qtdeGenes; i++)
+   {
+      VP_tabela[i].id   = i;
+      VP_tabela[i].ori  = genes[i].ulOrig;
+      VP_tabela[i].dest = genes[i].prDest;
+      VP_ordem[i] = i;
+      VP_posicao[i] = i;
+   }
 
    //Se o indivíduo foi modificado, o 2opt deve começar do início
    VP_Extra = extraPadrao;
 
-   VP_dist += VP_Mapa->get_distancia(VP_indice[VP_qtdeGenes-1]->ori, VP_indice[0]->dest);	
-	VP_distInv = 1/VP_dist;
+   verificaSimples();
+   recalcDist();
 }
 
 //Cria um novo indivíduo de um vetor de TGene
 void TIndividuo::novo (vector<TGene *> genes)
 {
-   TGene *gene;
-   VP_qtdeGenes = genes.size();
-   VP_direto.resize (VP_qtdeGenes);
-   VP_dist = 0;
+   alocaGenes (genes.size());
 
    for (int i=0; i<VP_qtdeGenes; i++)
    {
-      gene = new TGene;
-      gene->id   = genes[i]->id;
-      gene->ori  = genes[i]->ori;
-      gene->dest = genes[i]->dest;
-      gene->i    = i;
-
-      VP_direto[gene->id] = gene;
-      VP_indice.push_back (gene);
-
-      if (i==0) continue;
-      VP_indice[i]->ant = VP_indice[i-1];
-      VP_indice[i-1]->prox = VP_indice[i];
-
-      VP_dist += VP_Mapa->get_distancia(VP_indice[i-1]->ori, VP_indice[i]->dest);
+      VP_tabela[genes[i]->id] = *genes[i];
+      VP_ordem[i] = genes[i]->id;
+      VP_posicao[genes[i]->id] = i;
    }
 
-   //Fechando o ciclo
-   VP_indice[VP_qtdeGenes-1]->prox = VP_indice[0];
-   VP_indice[0]->ant = VP_indice[VP_qtdeGenes-1];
-
    //Se o indivíduo foi modificado, o 2opt deve começar do início
    VP_Extra = 0;
 
-   VP_dist += VP_Mapa->get_distancia(VP_indice[VP_qtdeGenes-1]->ori, VP_indice[0]->dest);
+   verificaSimples();
+   recalcDist();
+}
+
+//Com as cidades renumeradas na carga, a rota é escrita com os números
+//originais e a partir da cidade 0 da instância, como sem a renumeração
+int TIndividuo::get_inicioSaida ()
+{
+   if (VP_completo && VP_Mapa->is_renumerado())
+      for (int i=0; i<VP_qtdeGenes; i++)
+         if (VP_Mapa->get_idOriginal(VP_ordem[i])==0) return i;
+   return 0;
+}
+
+int TIndividuo::get_idSaida (TGene *gene)
+{
+   return VP_completo?VP_Mapa->get_idOriginal(gene->id):gene->id;
 }
 
 string TIndividuo::toString ()
 {
    string resultado = "";
-   for (vector< TGene *>::iterator i=VP_indice.begin(); i!=VP_indice.end(); ++i)
+   int inicio = get_inicioSaida();
+   for (int k=0; k<VP_qtdeGenes; k++)
    {
-     resultado += to_string( (*i)->id);
+     resultado += to_string( get_idSaida(get_por_indice((inicio+k)%VP_qtdeGenes)) );
      resultado += ";";
    }
    return resultado;
@@ -176,20 +231,21 @@ string TIndividuo::toString ()
 string TIndividuo::toStringExpand ()
 {
    string resultado = "";
-   for (vector< TGene *>::iterator i=VP_indice.begin(); i!=VP_indice.end(); ++i)
+   for (int i=0; i<VP_qtdeGenes; i++)
    {
-     resultado += to_string( (*i)->id);
+     TGene *gene = get_por_indice(i);
+     resultado += to_string( gene->id);
 	 resultado += "[";
-     resultado += to_string( (*i)->ori );
+     resultado += to_string( gene->ori );
      resultado += ",";
-     resultado += to_string( (*i)->dest );
+     resultado += to_string( gene->dest );
      resultado += "] ";
      resultado += "(";
-     resultado += to_string( (*i)->ant->id );
+     resultado += to_string( ant(gene)->id );
      resultado += ",";
-     resultado += to_string( (*i)->prox->id );
+     resultado += to_string( prox(gene)->id );
      resultado += " / ";
-     resultado += to_string( (*i)->i);
+     resultado += to_string( i );
      resultado += ")";
      resultado += ";";
    }
@@ -199,9 +255,10 @@ string TIndividuo::toStringExpand ()
 string TIndividuo::toString (int init)
 {
    string resultado = "";
-   for (vector< TGene *>::iterator i=VP_indice.begin(); i!=VP_indice.end(); ++i)
+   int inicio = get_inicioSaida();
+   for (int k=0; k<VP_qtdeGenes; k++)
    {
-     resultado += to_string( (*i)->id+1);
+     resultado += to_string( get_idSaida(get_por_indice((inicio+k)%VP_qtdeGenes))+1 );
      resultado += ";";
    }
    return resultado;
@@ -209,14 +266,14 @@ string TIndividuo::toString (int init)
 
 void TIndividuo::troca(int g1, int g2)
 {
-   troca_indice(VP_direto[g1]->i, VP_direto[g2]->i);
+   troca_indice(VP_posicao[g1], VP_posicao[g2]);
 }
 
 void TIndividuo::troca_indice(int index1, int index2)
 {
    if ((index1==0)||(index2==0)||(index1==index2)) return;
 
-   TGene *tempG;
+   int tempId;
 
    if(index1>index2)
    {
@@ -225,42 +282,31 @@ void TIndividuo::troca_indice(int index1, int index2)
       index2 = i;
    }
 
-   VP_dist -= VP_Mapa->get_distancia(VP_indice[ind_ant(index1)]->ori, VP_indice[index1]->dest);
-   VP_dist -= VP_Mapa->get_distancia(VP_indice[index2]->ori, VP_indice[ind_prox(index2)]->dest);
-   VP_dist -= VP_Mapa->get_distancia(VP_indice[index1]->ori, VP_indice[ind_prox(index1)]->dest);
+   VP_dist -= VP_Mapa->get_distancia(get_por_indice(ind_ant(index1))->ori, get_por_indice(index1)->dest);
+   VP_dist -= VP_Mapa->get_distancia(get_por_indice(index2)->ori, get_por_indice(ind_prox(index2))->dest);
+   VP_dist -= VP_Mapa->get_distancia(get_por_indice(index1)->ori, get_por_indice(ind_prox(index1))->dest);
 
    //se = distância de 1 a 1+1 = distância de 2-1 a 2
    //Seria contado duas vezes
    if((ind_prox(index1))!=index2)
-      VP_dist -= VP_Mapa->get_distancia(VP_indice[ind_ant(index2)]->ori, VP_indice[index2]->dest);
-
-   tempG = VP_indice[index1];
-   VP_indice[index1] = VP_indice[index2];
-   VP_indice[index2] = tempG;
-   VP_indice[index1]->i = index1;
-   VP_indice[index2]->i = index2;
-
-   //resolvendo o encadeamento para index1
-   VP_indice[ind_ant(index1)]->prox = VP_indice[index1];
-   VP_indice[index1]->ant = VP_indice[ind_ant(index1)];
-   VP_indice[index1]->prox = VP_indice[ind_prox(index1)];
-   VP_indice[ind_prox(index1)]->ant = VP_indice[index1];
-
-   //resolvendo o encadeamento para index2
-   VP_indice[ind_ant(index2)]->prox = VP_indice[index2];
-   VP_indice[index2]->ant = VP_indice[ind_ant(index2)];
-   VP_indice[index2]->prox = VP_indice[ind_prox(index2)];
-   VP_indice[ind_prox(index2)]->ant = VP_indice[index2];
+      VP_dist -= VP_Mapa->get_distancia(get_por_indice(ind_ant(index2))->ori, get_por_indice(index2)->dest);
+
+   //Os vizinhos vêm da posição, então basta trocar os ids
+   tempId = VP_ordem[index1];
+   VP_ordem[index1] = VP_ordem[index2];
+   VP_ordem[index2] = tempId;
+   VP_posicao[VP_ordem[index1]] = index1;
+   VP_posicao[VP_ordem[index2]] = index2;
 
    //Somando as novas dstâncias
-   VP_dist += VP_Mapa->get_distancia(VP_indice[ind_ant(index1)]->ori, VP_indice[index1]->dest);
-   VP_dist += VP_Mapa->get_distancia(VP_indice[index2]->ori, VP_indice[ind_prox(index2)]->dest);
-   VP_dist += VP_Mapa->get_distancia(VP_indice[index1]->ori, VP_indice[ind_prox(index1)]->dest);
+   VP_dist += VP_Mapa->get_distancia(get_por_indice(ind_ant(index1))->ori, get_por_indice(index1)->dest);
+   VP_dist += VP_Mapa->get_distancia(get_por_indice(index2)->ori, get_por_indice(ind_prox(index2))->dest);
+   VP_dist += VP_Mapa->get_distancia(get_por_indice(index1)->ori, get_por_indice(ind_prox(index1))->dest);
 
    //se = distância de 1 a 1+1 = distância de 2-1 a 2
    //Seria contado duas vezes
    if((ind_prox(index1))!=index2)
-      VP_dist += VP_Mapa->get_distancia(VP_indice[ind_ant(index2)]->ori, VP_indice[index2]->dest);
+      VP_dist += VP_Mapa->get_distancia(get_por_indice(ind_ant(index2))->ori, get_por_indice(index2)->dest);
 		
    VP_distInv = 1/VP_dist;
 }
@@ -274,7 +320,7 @@ void TIndividuo::troca_indice(int index1, int index2)
 */
 void TIndividuo::troca_sub(int index1, int size1, int index2, int size2)
 {
-   int ini1, ini2, increment1, increment2;
+   bool inv1 = false, inv2 = false;
 
    //Por convenção, a rota sempre iniciará no gene 0
    //logo, este não pode ser trocado
@@ -283,54 +329,71 @@ void TIndividuo::troca_sub(int index1, int size1, int index2, int size2)
    //Não há troca a ser feita
    if ((size1==size2)&&(size1==0)) return;
 
-   if (size1>0) 
-   { 
-      ini1 = index1;
-      increment1 = 1;
-   }
-   else //Inverte o bloco
+   if (size1<0) //Inverte o bloco
    {
       size1 *= -1;
-      ini1 = index1+size1-1;
-      increment1 = -1;
+      inv1 = true;
    }
 
-   if (size2>0) 
-   { 
-      ini2 = index2;
-      increment2 = 1;
-   }
-   else //Inverte inverte o bloco
+   if (size2<0) //Inverte o bloco
    {
       size2 *= -1;
-      ini2 = index2+size2-1;
-      increment2 = -1;
+      inv2 = true;
    }
    
    //Não pode sobrepor
    if (index1+size1>index2) return;
    //Não pode ultrapassar
    if (index2+size2>this->get_qtdeGenes()) return;
- 
-   //Montando os bolocos
-   int v1[size1];
-   int v2[size2];
-   int vm[index2-index1-size1];
-  
-   //Montando o prmeiro bloco
-   for (int i = 0, j=ini1; i<size1; i++, j+=increment1) v1[i] = this->VP_indice[j]->id; 
-   //Montando a parte entre os 2 blocos
-   for(int i = 0, j=index1+size1; i<index2-index1-size1; i++, j++) vm[i] = this->VP_indice[j]->id;
-   //Montando o segundo bloco
-   for (int i = 0, j=ini2; i<size2; i++, j+=increment2) v2[i] = this->VP_indice[j]->id;
-
-   //Remontando o indivíduo
-   //o segundo bloco passa a ser o prmeiro
-   for (int i = 0, j=index1; i<size2; i++, j++) this->troca (this->VP_indice[j]->id, v2[i]); 
-   //O bloco do meio
-   for(int i = 0, j=index1+size2; i<index2-index1-size1; i++, j++) this->troca (this->VP_indice[j]->id,vm[i]);
-   //o prmeiro bloco passará a ser o segundo
-   for (int i = 0, j=index2+size2-size1; i<size1; i++, j++) this->troca (this->VP_indice[j]->id, v1[i]); 	
+
+   //O trecho [index1, fim) passa de B1 M B2 para B2 M B1
+   int fim = index2+size2;
+   int tamM = index2-index1-size1;
+
+   //Só mudam as arestas nas divisas dos blocos. Divisas que coincidem
+   //(bloco vazio) são contadas uma vez
+   int antes[4] = {index1, index1+size1, index2, fim};
+   int depois[4] = {index1, index1+size2, index1+size2+tamM, fim};
+   int qtdeAntes = unique(antes, antes+4)-antes;
+   int qtdeDepois = unique(depois, depois+4)-depois;
+   int i;
+
+   for (i=0; i<qtdeAntes; i++) VP_dist -= get_dist_aresta(antes[i]-1);
+   //Fora da matriz simétrica, um bloco invertido muda o custo das suas arestas
+   if (!is_simetrico())
+   {
+      if (inv1) VP_dist -= get_dist_trecho(index1, index1+size1);
+      if (inv2) VP_dist -= get_dist_trecho(index2, fim);
+   }
+
+   //Inverte o trecho todo (B2' M' B1') e desfaz a inversão de cada parte
+   //que não deveria ficar invertida
+   vector<int>::iterator it = VP_ordem.begin();
+   reverse(it+index1, it+fim);
+   if (!inv2) reverse(it+index1, it+index1+size2);
+   reverse(it+index1+size2, it+index1+size2+tamM);
+   if (!inv1) reverse(it+index1+size2+tamM, it+fim);
+   for (i=index1; i<fim; i++) VP_posicao[VP_ordem[i]] = i;
+
+   for (i=0; i<qtdeDepois; i++) VP_dist += get_dist_aresta(depois[i]-1);
+   if (!is_simetrico())
+   {
+      if (inv2) VP_dist += get_dist_trecho(index1, index1+size2);
+      if (inv1) VP_dist += get_dist_trecho(index1+size2+tamM, fim);
+   }
+   VP_distInv = 1/VP_dist;
+}
+
+double TIndividuo::get_dist_aresta (int indice)
+{
+   return VP_Mapa->get_distancia(get_por_indice(indice)->ori, get_por_indice(ind_prox(indice))->dest);
+}
+
+double TIndividuo::get_dist_trecho (int ini, int fim)
+{
+   double tot = 0;
+   for (int i=ini; i<fim-1; i++) tot += get_dist_aresta(i);
+   return tot;
 }
 
 void TIndividuo::embaralha ()
@@ -362,53 +425,82 @@ void TIndividuo::recalcDist ()
 {
 	VP_dist = 0;
 
-	for (int i = 0; i<VP_qtdeGenes; i++)
-      VP_dist += VP_Mapa->get_distancia(VP_indice[ind_ant(i)]->ori, VP_indice[i]->dest);
+   //Com distâncias inteiras, a soma é feita em inteiro e não acumula erro
+   if (VP_Mapa->is_inteira())
+   {
+      long soma = 0;
+      for (int i = 0; i<VP_qtdeGenes; i++)
+         soma += VP_Mapa->get_distanciaInt(get_por_indice(ind_ant(i))->ori, get_por_indice(i)->dest);
+      VP_dist = soma;
+   }
+   else
+	   for (int i = 0; i<VP_qtdeGenes; i++)
+         VP_dist += VP_Mapa->get_distancia(get_por_indice(ind_ant(i))->ori, get_por_indice(i)->dest);
 	
 	VP_distInv = 1/VP_dist;
 }
 
+void TIndividuo::verificaSimples ()
+{
+   VP_simples = true;
+   VP_completo = (VP_qtdeGenes == VP_Mapa->get_qtdeGenes());
+   for (int i = 0; i<VP_qtdeGenes; i++)
+   {
+      if (VP_tabela[i].ori != VP_tabela[i].dest)
+      {
+         VP_simples = false;
+         VP_completo = false;
+         break;
+      }
+      if (VP_tabela[i].id != VP_tabela[i].ori) VP_completo = false;
+   }
+}
+
 double TIndividuo::get_dist_sub_reverso(TGene *G1, TGene *G2)
 {
-   TGene *tempG;
+   return get_dist_sub_reverso_indice (VP_posicao[G1->id], VP_posicao[G2->id]);
+}
 
-   if ((G1->i==0)||(G2->i==0)||(G1->i == G2->i)) return VP_dist;
-   else if (G1->i > G2->i)
+double TIndividuo::get_dist_sub_reverso_id(int id1, int id2)
+{
+   return get_dist_sub_reverso_indice (VP_posicao[id1], VP_posicao[id2]);
+}
+
+double TIndividuo::get_dist_sub_reverso_indice(int indice1, int indice2)
+{
+   int i;
+
+   if ((indice1==0)||(indice2==0)||(indice1 == indice2)) return VP_dist;
+   else if (indice1 > indice2)
    {
-      tempG = G1;
-      G1 = G2;
-      G2 = tempG;
+      i = indice1;
+      indice1 = indice2;
+      indice2 = i;
    }
 
    double tot=VP_dist;
+   TGene *G1 = get_por_indice(indice1);
+   TGene *G2 = get_por_indice(indice2);
 
    //Entre os genes 1 e 2, a soma é do caminho de retorno ou seja, de 2 para 1
-   for (tempG=G1; tempG->id!=G2->id; tempG = tempG->prox)
-   {
-      tot -= VP_Mapa->get_distancia(tempG->ori, tempG->prox->dest);
-      tot += VP_Mapa->get_distancia(tempG->prox->ori, tempG->dest);
-   }
+   //Na matriz simétrica, o caminho de retorno custa o mesmo que o de ida
+   if (!is_simetrico())
+      for (i=indice1; i<indice2; i++)
+      {
+         tot -= VP_Mapa->get_distancia(get_por_indice(i)->ori, get_por_indice(i+1)->dest);
+         tot += VP_Mapa->get_distancia(get_por_indice(i+1)->ori, get_por_indice(i)->dest);
+      }
 
    //Arestas que ficaram faltando
-   tot -= VP_Mapa->get_distancia(G1->ant->ori, G1->dest);
-   tot -= VP_Mapa->get_distancia(G2->ori, G2->prox->dest);
+   tot -= VP_Mapa->get_distancia(get_por_indice(indice1-1)->ori, G1->dest);
+   tot -= VP_Mapa->get_distancia(G2->ori, get_por_indice(ind_prox(indice2))->dest);
 
-   tot += VP_Mapa->get_distancia(G1->ant->ori, G2->dest);
-   tot += VP_Mapa->get_distancia(G1->ori, G2->prox->dest);
+   tot += VP_Mapa->get_distancia(get_por_indice(indice1-1)->ori, G2->dest);
+   tot += VP_Mapa->get_distancia(G1->ori, get_por_indice(ind_prox(indice2))->dest);
 
    return tot;
 }
 
-double TIndividuo::get_dist_sub_reverso_id(int id1, int id2)
-{
-   return get_dist_sub_reverso (VP_direto[id1], VP_direto[id2]);
-}
-
-double TIndividuo::get_dist_sub_reverso_indice(int indice1, int indice2)
-{
-   return get_dist_sub_reverso (VP_indice[indice1], VP_indice[indice2]);
-}
-
 void TIndividuo::inverte_sub_indice (int indice1, int indice2)
 {
    int i;
@@ -420,69 +512,129 @@ void TIndividuo::inverte_sub_indice (int indice1, int indice2)
       indice2 = i;
    }
 
-   for (i=0; i<=(indice2-indice1)/2;i++)
-      troca_indice(indice1+i, indice2-i);
+   //Só mudam as arestas das pontas e, fora da matriz simétrica, o sentido
+   //das arestas internas. O custo é calculado uma vez, sem trocas par a par
+   VP_dist = get_dist_sub_reverso_indice(indice1, indice2);
+   VP_distInv = 1/VP_dist;
+
+   std::reverse(VP_ordem.begin()+indice1, VP_ordem.begin()+indice2+1);
+   for (i=indice1; i<=indice2; i++) VP_posicao[VP_ordem[i]] = i;
 }
 
 void TIndividuo::inverte_sub (TGene *G1, TGene *G2)
 {
-   inverte_sub_indice (G1->i, G2->i);
+   inverte_sub_indice (VP_posicao[G1->id], VP_posicao[G2->id]);
 }
 
 void TIndividuo::inverte_sub_id (int id1, int id2)
 {
-   inverte_sub_indice (VP_direto[id1]->i, VP_direto[id2]->i);
+   inverte_sub_indice (VP_posicao[id1], VP_posicao[id2]);
 }
 
 //Clona o individuo. Necessário para o elitismo
 TIndividuo *TIndividuo::clona ()
 {
-   TIndividuo *clone = new TIndividuo(getMapa(), getArqLog());
-   clone->novo(VP_indice);
-   clone->set_extra(get_extra());
+   TIndividuo *clone = TPoolIndividuos::aloca(VP_pool, getMapa(), getArqLog());
+   clone->copyFrom(*this);
    return clone;
 }
 
+void TIndividuo::copyFrom (const TIndividuo &origem)
+{
+   if (this == &origem) return;
+
+   VP_Mapa = origem.VP_Mapa;
+   VP_ArqSaida = origem.VP_ArqSaida;
+
+   //A tabela de genes não muda, então é compartilhada. As atribuições
+   //dos vetores usam a capacidade que este indivíduo já tem
+   VP_genes = origem.VP_genes;
+   VP_tabela = origem.VP_tabela;
+   VP_ordem = origem.VP_ordem;
+   VP_posicao = origem.VP_posicao;
+   VP_qtdeGenes = origem.VP_qtdeGenes;
+   VP_simples = origem.VP_simples;
+   VP_completo = origem.VP_completo;
+   VP_dist = origem.VP_dist;
+   VP_distInv = origem.VP_distInv;
+   VP_Extra = origem.VP_Extra;
+}
+
 int TIndividuo::melhorPossivel()
 {
-   int melhorou = 0; //retrna false (=0) quando não mehora ou true (!=0) quando melhora 
-   vector<TGene *> melhor;
-   vector<TGene *> temp;
-   double melhorDist = get_distancia();
-   double distTemp;
+   //Held-Karp (1962): programação dinâmica sobre os subconjuntos de genes,
+   //em O(n².2^n), fixando o 0, pois é um ciclo. O custo de ir de a para b
+   //é o da saída de a (ori) até a entrada de b (dest), como nos fragmentos
+   int qtde = get_qtdeGenes()-1;
+   if ((qtde<2)||(get_qtdeGenes()>maxGenesExato)) return 0;
+
+   int todos = (1<<qtde)-1;
+   vector<double> custo(qtde*qtde);
+   vector<double> custoIni(qtde);
+   vector<double> custoFim(qtde);
+
+   //Gene j+1 no bit j. custo[k*qtde+j] é a chegada ao k vindo do j
+   for (int j=0; j<qtde; j++)
+   {
+      custoIni[j] = VP_Mapa->get_distancia(VP_tabela[0].ori, VP_tabela[j+1].dest);
+      custoFim[j] = VP_Mapa->get_distancia(VP_tabela[j+1].ori, VP_tabela[0].dest);
+      for (int k=0; k<qtde; k++)
+         custo[k*qtde+j] = VP_Mapa->get_distancia(VP_tabela[j+1].ori, VP_tabela[k+1].dest);
+   }
 
-   //Realizando todas as combinações, fixando o 0, pois é um ciclo
-   for(int i=1;i<get_qtdeGenes();++i) temp.push_back(get_por_id(i));
+   //caminho[c*qtde+j]: menor caminho que sai do 0, passa pelos genes de c e termina no j.
+   //Fica infinito quando j não está em c, então o mínimo pode varrer todos os j
+   vector<double> caminho((size_t)(todos+1)*qtde, numeric_limits<double>::infinity());
+   for (int j=0; j<qtde; j++) caminho[(size_t)(1<<j)*qtde+j] = custoIni[j];
 
-   do
-   {
-      //Calculando o peso total de cada permutação
-      distTemp = VP_Mapa->get_distancia(VP_direto[0]->ori, temp[0]->dest);
-      for (unsigned i=1;i<temp.size();++i) distTemp += VP_Mapa->get_distancia(temp[i-1]->ori, temp[i]->dest);
-      distTemp += VP_Mapa->get_distancia(temp[temp.size()-1]->ori ,VP_direto[0]->dest);
+   for (int c=1; c<=todos; c++)
+      for (int k=0; k<qtde; k++)
+      {
+         int ant = c^(1<<k);
+         if ((ant==0)||(ant>c)) continue;   //k não está em c, ou é o primeiro gene
+
+         const double *origem = &caminho[(size_t)ant*qtde];
+         const double *chegada = &custo[k*qtde];
+         double min = origem[0]+chegada[0];
+         for (int j=1; j<qtde; j++)
+            if (origem[j]+chegada[j] < min) min = origem[j]+chegada[j];
+         caminho[(size_t)c*qtde+k] = min;
+      }
 
-      if (distTemp<melhorDist)
+   int fim = 0;
+   double melhorDist = caminho[(size_t)todos*qtde]+custoFim[0];
+   for (int j=1; j<qtde; j++)
+      if (caminho[(size_t)todos*qtde+j]+custoFim[j] < melhorDist)
       {
-         melhorDist = distTemp;
-         melhor = temp;
+         melhorDist = caminho[(size_t)todos*qtde+j]+custoFim[j];
+         fim = j;
       }
-   }while(next_permutation(temp.begin(),temp.end()));
 
    //Se encontrei combinação melhor do que a existente
-   if (melhorDist<get_distancia())
+   if (melhorDist>=get_distancia()) return 0;
+
+   //Refaz o caminho de trás para frente: o anterior de j é o que dá o menor caminho até ele
+   vector<int> rota(get_qtdeGenes());
+   rota[0] = 0;
+   for (int c=todos, j=fim, i=qtde; i>=1; i--)
    {
-      melhorou = 1;
-      //Mudo o individuo para mesma sequência do melhor
-      for (int i=1;i<get_qtdeGenes()-1;++i)
-      {
-         if (VP_indice[i]->id!=melhor[i-1]->id)
-            troca_indice(i, (get_por_id(melhor[i-1]->id))->i);
-      }
+      rota[i] = j+1;
+      c ^= (1<<j);
+      if (c==0) break;
+
+      int ant = -1;
+      double min = numeric_limits<double>::infinity();
+      for (int k=0; k<qtde; k++)
+         if (caminho[(size_t)c*qtde+k]+custo[j*qtde+k] < min)
+         {
+            min = caminho[(size_t)c*qtde+k]+custo[j*qtde+k];
+            ant = k;
+         }
+      j = ant;
    }
-   
-   melhor.clear();
-   temp.clear();
-   
-   return melhorou;
+
+   //Mudo o individuo para mesma sequência do melhor
+   set_rota(&rota[0]);
+   return 1;
 }
 
@@ -15,13 +15,24 @@
 
 
 #include <vector>
+#include <memory>
 #include "tsp.hpp"
 #include "arqlog.hpp"
 #include "utils.hpp"
 #include <algorithm>
 
+class TPoolIndividuos;
+
 /**************************************************
-class indivíduo. Uma sequência de genes encadeados
+class indivíduo. Uma sequência de genes. A rota fica
+em dois vetores de inteiros: VP_ordem tem o id do gene
+em cada posição e VP_posicao a posição de cada id. Os
+vizinhos são obtidos pela posição, sem ponteiros.
+Os genes (id, ori e dest) não mudam depois de criados
+e a tabela é compartilhada entre o indivíduo e seus
+clones, de modo que clonar é copiar os dois vetores.
+Por isso um TGene não sabe a sua posição: ela deve ser
+pedida ao indivíduo (get_indice, prox e ant)
 ***************************************************/
 
 class TIndividuo
@@ -29,47 +40,81 @@ class TIndividuo
    private:
       int VP_Extra;
 
-      vector <TGene *> VP_direto;
-      vector <TGene *> VP_indice;
+      shared_ptr <vector <TGene> > VP_genes;  //Indexada pelo id
+      TGene *VP_tabela;                       //VP_genes->data()
+      vector <int> VP_ordem;                  //Posição -> id
+      vector <int> VP_posicao;                //Id -> posição
 
       int VP_qtdeGenes;
+      bool VP_simples;   //Todo gene tem ori==dest (não é um fragmento)
+      bool VP_completo;  //Os genes são as próprias cidades do mapa (id==ori==dest)
       double VP_dist;
 		double VP_distInv; // 1/VP_dist para roleta
 
-      int VP_qtdeGeneAlloc;
-
       TMapaGenes *VP_Mapa;
       TArqLog *VP_ArqSaida;
+      TPoolIndividuos *VP_pool;               //NULL quando alocado com new
+
+      //Nova tabela de genes, ainda sem rota
+      void alocaGenes (int qtde);
+
+      //Custo da aresta que sai da posição indice e das arestas internas de [ini, fim)
+      double get_dist_aresta (int indice);
+      double get_dist_trecho (int ini, int fim);
+
+      //Saída com os números das cidades na instância
+      int get_inicioSaida ();
+      int get_idSaida (TGene *gene);
 
    public:
 
       //Apenas leitura
       TMapaGenes *getMapa();
       TArqLog *getArqLog();
+      TPoolIndividuos *get_pool();
 
       //Propriedades
       int get_extra ();
       void set_extra (int val);
 
       //Métodos
-      TIndividuo (TMapaGenes *mapa, TArqLog *arqSaida);
+      TIndividuo (TMapaGenes *mapa, TArqLog *arqSaida, TPoolIndividuos *pool = NULL);
+      //Cópias e movimentos não pertencem a nenhum pool. Na atribuição,
+      //o destino continua no seu pool
+      TIndividuo (const TIndividuo &origem);
+      TIndividuo (TIndividuo &&origem) noexcept;
+      TIndividuo &operator= (const TIndividuo &origem);
+      TIndividuo &operator= (TIndividuo &&origem) noexcept;
 
       ~TIndividuo();
 
-      TGene *get_por_indice (int indice);
-      TGene *get_por_id (int id);
-      TGene *get_ini ();
+      //Acessos à rota, usados em todos os laços dos operadores
+      TGene *get_por_indice (int indice) { return &VP_tabela[VP_ordem[indice]]; }
+      TGene *get_por_id (int id)         { return &VP_tabela[id]; }
+      TGene *get_ini ()                  { return get_por_indice(0); }
+
+      //Posição do gene na rota deste indivíduo
+      int get_indice (TGene *gene)       { return VP_posicao[gene->id]; }
+      int get_indice_id (int id)         { return VP_posicao[id]; }
 
-      int ind_prox(int ind);
-      TGene *prox (TGene *gene);
-      TGene *prox (int idG);
+      int ind_prox(int ind)              { return (ind<(VP_qtdeGenes-1))?ind+1:0; }
+      TGene *prox (TGene *gene)          { return get_por_indice(ind_prox(VP_posicao[gene->id])); }
+      TGene *prox (int idG)              { return get_por_indice(ind_prox(VP_posicao[idG])); }
 
-      int ind_ant(int ind);
-      TGene *ant (TGene *gene);
-      TGene *ant (int idG);
+      int ind_ant(int ind)               { return (ind>0)?ind-1:(VP_qtdeGenes-1); }
+      TGene *ant (TGene *gene)           { return get_por_indice(ind_ant(VP_posicao[gene->id])); }
+      TGene *ant (int idG)               { return get_por_indice(ind_ant(VP_posicao[idG])); }
 
       int get_qtdeGenes();
 
+      //Verdadeiro quando inverter uma sub-rota só altera as arestas das
+      //pontas: matriz simétrica e nenhum gene é fragmento (ori==dest)
+      bool is_simetrico();
+
+      //Verdadeiro quando o gene de id c é a cidade c do mapa. Só então as
+      //listas de candidatos do mapa podem ser usadas diretamente
+      bool is_completo();
+
       double get_distancia ();
 		double get_distanciaInv ();
 
@@ -79,6 +124,12 @@ class TIndividuo
 		void novo (vector<TGene *> genes);
 	  //Cria um novo individuo a partir da tabela de conversão
       void novo (vector<TTipoConversao> genes, int extraPadrao);
+      //Cria um novo indivíduo com as cidades do mapa na ordem da rota
+      //(rota[0] deve ser o gene 0)
+      void novo (const int *rota);
+      //Reordena os genes deste indivíduo pela rota de ids, mantendo a
+      //tabela de genes (rota[0] deve ser o gene 0)
+      void set_rota (const int *rota);
 
       string toString ();
       string toString (int init);
@@ -94,6 +145,7 @@ class TIndividuo
 		//      será como se movesse o outro.
 		//      Se o tamanho for negativo,
 		//      além da troca, haverá uma inversão do bloco        
+		//      O custo é linear no trecho, sem cópias auxiliares
 		void troca_sub(int index1, int size1, int index2, int size2);
 	  
       //Embaralha os genes de um individuo
@@ -101,6 +153,8 @@ class TIndividuo
       void embaralha (int index1, int index2);
       //Recalcula o valor de um indivduo
       void recalcDist ();
+      //Verifica se todos os genes tem ori==dest e se são as cidades do mapa
+      void verificaSimples ();
 
       //Calcula a distância total no caso de uma sub-rota ser invertida
       double get_dist_sub_reverso(TGene *G1, TGene *G2);
@@ -112,8 +166,16 @@ class TIndividuo
       void inverte_sub (TGene *G1, TGene *G2);
       void inverte_sub_id (int id1, int id2);
 
-      //Clona o individuo. Necessário para o elitismo
+      //Clona o individuo. Necessário para o elitismo.
+      //O clone compartilha a tabela de genes e copia a rota.
+      //Vem do mesmo pool do indivíduo, se houver
       TIndividuo *clona ();
+      //Copia a rota de outro indivíduo, reaproveitando a memória
+      //deste. A distância é copiada, sem recalcular
+      void copyFrom (const TIndividuo &origem);
+      //Melhor rota possível por programação dinâmica (Held-Karp), para
+      //indivíduos reduzidos de até maxGenesExato genes. Retorna se melhorou
+      static const int maxGenesExato = 20;
       int melhorPossivel ();
 };
 
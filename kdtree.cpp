@@ -0,0 +1,226 @@
+/*
+*  kdtree.cpp
+*
+*  Módulo responsável pelo índice espacial das instâncias por coordenadas
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "kdtree.hpp"
+#include <algorithm>
+
+TKdTree::TKdTree ()
+{
+   VP_qtde = 0;
+   VP_qtdeAtivos = 0;
+}
+
+int TKdTree::get_qtde () const       { return VP_qtde; }
+int TKdTree::get_qtdeAtivos () const { return VP_qtdeAtivos; }
+
+void TKdTree::constroi (const double *x, const double *y, int qtde)
+{
+   VP_qtde = qtde;
+   VP_qtdeAtivos = qtde;
+
+   std::vector<int> ordem(qtde);
+   for (int i=0; i<qtde; i++) ordem[i] = i;
+
+   VP_eixo.assign(qtde, 0);
+   VP_ativos.assign(qtde, 0);
+   VP_removido.assign(qtde, 0);
+   constroi(ordem, x, y, 0, qtde);
+
+   VP_x.resize(qtde);
+   VP_y.resize(qtde);
+   VP_id.resize(qtde);
+   VP_posicao.resize(qtde);
+   for (int p=0; p<qtde; p++)
+   {
+      VP_x[p] = x[ordem[p]];
+      VP_y[p] = y[ordem[p]];
+      VP_id[p] = ordem[p];
+      VP_posicao[ordem[p]] = p;
+   }
+}
+
+void TKdTree::constroi (std::vector<int> &ordem, const double *x, const double *y, int ini, int fim)
+{
+   if (ini>=fim) return;
+
+   int mid = (ini+fim)/2;
+   VP_ativos[mid] = fim-ini;
+   if (fim-ini==1) return;
+
+   //Divide pelo eixo de maior amplitude
+   double xMin = x[ordem[ini]], xMax = xMin;
+   double yMin = y[ordem[ini]], yMax = yMin;
+   for (int p=ini+1; p<fim; p++)
+   {
+      int i = ordem[p];
+      if (x[i]<xMin) xMin = x[i];
+      if (x[i]>xMax) xMax = x[i];
+      if (y[i]<yMin) yMin = y[i];
+      if (y[i]>yMax) yMax = y[i];
+   }
+
+   const double *c = ((xMax-xMin)>=(yMax-yMin))?x:y;
+   VP_eixo[mid] = (c==x)?0:1;
+
+   //À esquerda da mediana ficam os menores ou iguais, à direita os maiores ou iguais
+   std::nth_element(ordem.begin()+ini, ordem.begin()+mid, ordem.begin()+fim,
+                    [c](int a, int b) { return c[a]<c[b]; });
+
+   constroi(ordem, x, y, ini, mid);
+   constroi(ordem, x, y, mid+1, fim);
+}
+
+void TKdTree::buscaProximos (int ini, int fim, double qx, double qy, int k, int ignorar, int quadrante,
+                             std::vector<std::pair<double, int> > &heap) const
+{
+   if (ini>=fim) return;
+
+   int mid = (ini+fim)/2;
+   if (VP_ativos[mid]==0) return;
+
+   double dx = qx - VP_x[mid];
+   double dy = qy - VP_y[mid];
+
+   if ((!VP_removido[mid])&&(VP_id[mid]!=ignorar)&&
+       ((quadrante==todosQuadrantes)||(quadrante==((VP_x[mid]>=qx)?0:1)+((VP_y[mid]>=qy)?0:2))))
+   {
+      std::pair<double, int> candidato (dx*dx + dy*dy, VP_id[mid]);
+      if ((int)heap.size()<k)
+      {
+         heap.push_back(candidato);
+         std::push_heap(heap.begin(), heap.end());
+      }
+      else if (candidato<heap.front())
+      {
+         std::pop_heap(heap.begin(), heap.end());
+         heap.back() = candidato;
+         std::push_heap(heap.begin(), heap.end());
+      }
+   }
+
+   if (fim-ini==1) return;
+
+   int eixo = VP_eixo[mid];
+   double diff = eixo?dy:dx;
+
+   //Subárvores fora do quadrante pedido não são visitadas
+   bool esquerda = true, direita = true;
+   if (quadrante!=todosQuadrantes)
+   {
+      bool menor = (quadrante>>eixo)&1;
+      if (!menor&&(diff>0)) esquerda = false;   //Quer c>=q, e a esquerda tem c<=s<q
+      if (menor&&(diff<=0)) direita = false;    //Quer c<q, e a direita tem c>=s>=q
+   }
+
+   //Primeiro o lado da busca, depois o outro, se ainda puder ter algum mais próximo
+   if (diff<0)
+   {
+      if (esquerda) buscaProximos(ini, mid, qx, qy, k, ignorar, quadrante, heap);
+      if (direita&&(((int)heap.size()<k)||(diff*diff<=heap.front().first)))
+         buscaProximos(mid+1, fim, qx, qy, k, ignorar, quadrante, heap);
+   }
+   else
+   {
+      if (direita) buscaProximos(mid+1, fim, qx, qy, k, ignorar, quadrante, heap);
+      if (esquerda&&(((int)heap.size()<k)||(diff*diff<=heap.front().first)))
+         buscaProximos(ini, mid, qx, qy, k, ignorar, quadrante, heap);
+   }
+}
+
+int TKdTree::maisProximos (double x, double y, int k, int ignorar, int *lista, int quadrante) const
+{
+   if (k<=0) return 0;
+
+   std::vector<std::pair<double, int> > heap;
+   heap.reserve(k);
+   buscaProximos(0, VP_qtde, x, y, k, ignorar, quadrante, heap);
+
+   std::sort_heap(heap.begin(), heap.end());
+   for (unsigned i=0; i<heap.size(); i++) lista[i] = heap[i].second;
+   return heap.size();
+}
+
+int TKdTree::maisProximo (double x, double y, int ignorar) const
+{
+   int id;
+   return (maisProximos(x, y, 1, ignorar, &id)==1)?id:-1;
+}
+
+void TKdTree::buscaRaio (int ini, int fim, double qx, double qy, double raio2,
+                         std::vector<std::pair<double, int> > &achados) const
+{
+   if (ini>=fim) return;
+
+   int mid = (ini+fim)/2;
+   if (VP_ativos[mid]==0) return;
+
+   double dx = qx - VP_x[mid];
+   double dy = qy - VP_y[mid];
+   double d2 = dx*dx + dy*dy;
+
+   if ((!VP_removido[mid])&&(d2<=raio2)) achados.push_back(std::pair<double, int> (d2, VP_id[mid]));
+   if (fim-ini==1) return;
+
+   double diff = VP_eixo[mid]?dy:dx;
+   if ((diff<0)||(diff*diff<=raio2)) buscaRaio(ini, mid, qx, qy, raio2, achados);
+   if ((diff>=0)||(diff*diff<=raio2)) buscaRaio(mid+1, fim, qx, qy, raio2, achados);
+}
+
+void TKdTree::noRaio (double x, double y, double raio, std::vector<int> &lista) const
+{
+   std::vector<std::pair<double, int> > achados;
+
+   lista.clear();
+   if (raio<0) return;
+
+   buscaRaio(0, VP_qtde, x, y, raio*raio, achados);
+   std::sort(achados.begin(), achados.end());
+   for (unsigned i=0; i<achados.size(); i++) lista.push_back(achados[i].second);
+}
+
+void TKdTree::remove (int id)
+{
+   int p = VP_posicao[id];
+   if (VP_removido[p]) return;
+
+   //Desce da raiz até o ponto, descontando-o de cada subárvore no caminho
+   int ini = 0, fim = VP_qtde;
+   while (true)
+   {
+      int mid = (ini+fim)/2;
+      VP_ativos[mid]--;
+      if (mid==p) break;
+      if (p<mid) fim = mid;
+      else       ini = mid+1;
+   }
+   VP_removido[p] = 1;
+   VP_qtdeAtivos--;
+}
+
+void TKdTree::reiniciaAtivos (int ini, int fim)
+{
+   if (ini>=fim) return;
+
+   int mid = (ini+fim)/2;
+   VP_ativos[mid] = fim-ini;
+   reiniciaAtivos(ini, mid);
+   reiniciaAtivos(mid+1, fim);
+}
+
+void TKdTree::restaura ()
+{
+   if (VP_qtdeAtivos==VP_qtde) return;
+
+   VP_removido.assign(VP_qtde, 0);
+   reiniciaAtivos(0, VP_qtde);
+   VP_qtdeAtivos = VP_qtde;
+}
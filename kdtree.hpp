@@ -0,0 +1,88 @@
+/*
+*  kdtree.hpp
+*
+*  Módulo responsável pelo índice espacial das instâncias por coordenadas
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _KDTREE_H
+#define	_KDTREE_H
+
+#include <vector>
+
+/*******************************************************
+classe de TKdTree. Árvore k-d (2 dimensões) sobre os pontos
+de uma instância. A árvore é implícita: os pontos ficam em
+um vetor, e cada nó é a mediana do seu intervalo, dividindo
+pelo eixo de maior amplitude. A construção é O(n log n) e
+as buscas visitam O(log n) nós em média.
+
+As buscas usam a distância euclidiana. As distâncias do
+TSPLIB no plano (EUC_2D, CEIL_2D e ATT) crescem junto com
+ela, então os mais próximos na árvore são os mais próximos
+na instância. Empates são desfeitos pelo id do ponto.
+
+Pontos podem ser retirados (remove) e devolvidos todos de
+uma vez (restaura), para construções gulosas como a rota
+do vizinho mais próximo. As buscas são somente leitura e
+podem ser feitas por várias threads, desde que nenhuma
+remova pontos ao mesmo tempo.
+********************************************************/
+class TKdTree
+{
+   public:
+      //Quadrantes em volta do ponto de busca (qx,qy):
+      //bit 0 ligado quando x<qx, bit 1 ligado quando y<qy
+      static const int todosQuadrantes = -1;
+
+   private:
+      int VP_qtde;
+      int VP_qtdeAtivos;
+
+      //Pontos na ordem da árvore
+      std::vector<double> VP_x;
+      std::vector<double> VP_y;
+      std::vector<int> VP_id;
+      std::vector<int> VP_posicao;          //Posição de cada id na árvore
+
+      //Por nó, indexados pela posição da mediana
+      std::vector<unsigned char> VP_eixo;   //0 divide por x, 1 por y
+      std::vector<int> VP_ativos;           //Pontos não removidos na subárvore
+      std::vector<unsigned char> VP_removido;
+
+      void constroi (std::vector<int> &ordem, const double *x, const double *y, int ini, int fim);
+      void reiniciaAtivos (int ini, int fim);
+
+      void buscaProximos (int ini, int fim, double qx, double qy, int k, int ignorar, int quadrante,
+                          std::vector<std::pair<double, int> > &heap) const;
+      void buscaRaio (int ini, int fim, double qx, double qy, double raio2,
+                      std::vector<std::pair<double, int> > &achados) const;
+
+   public:
+      TKdTree ();
+
+      void constroi (const double *x, const double *y, int qtde);
+
+      int get_qtde () const;
+      int get_qtdeAtivos () const;
+
+      //Até k pontos mais próximos de (x,y), do mais próximo para o mais
+      //distante, sem o ponto ignorar (-1 para nenhum). Com quadrante,
+      //apenas os pontos daquele quadrante. Retorna quantos encontrou
+      int maisProximos (double x, double y, int k, int ignorar, int *lista,
+                        int quadrante = todosQuadrantes) const;
+      int maisProximo (double x, double y, int ignorar) const;
+
+      //Pontos a até raio de (x,y), do mais próximo para o mais distante
+      void noRaio (double x, double y, double raio, std::vector<int> &lista) const;
+
+      void remove (int id);
+      void restaura ();
+};
+
+#endif	/* _KDTREE_H */
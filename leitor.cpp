@@ -0,0 +1,280 @@
+/*
+*  leitor.cpp
+*
+*  Módulo responsável pela leitura sequencial dos arquivos de instância
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "leitor.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//Potências de 10 representadas sem erro em double
+static const double potencias10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+static inline bool isDigito(char c) { return (c>='0')&&(c<='9'); }
+static inline bool isEspaco(char c) { return (c==' ')||(c=='\t')||(c=='\r')||(c=='\n'); }
+
+TLeitor::TLeitor ()
+{
+   VP_buffer = NULL;
+   VP_tamanho = 0;
+   VP_mapeado = false;
+   VP_dono = true;
+   VP_pos = NULL;
+   VP_fim = NULL;
+}
+
+TLeitor::~TLeitor ()
+{
+   fecha();
+}
+
+bool TLeitor::abre (const char *nomeArquivo)
+{
+   struct stat info;
+
+   fecha();
+
+   int fd = open(nomeArquivo, O_RDONLY);
+   if (fd < 0) return false;
+
+   if (fstat(fd, &info) != 0)
+   {
+      close(fd);
+      return false;
+   }
+   VP_tamanho = info.st_size;
+
+   long pagina = sysconf(_SC_PAGESIZE);
+   if ((VP_tamanho > 0)&&((VP_tamanho % pagina) != 0))
+   {
+      void *area = mmap(NULL, VP_tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (area != MAP_FAILED)
+      {
+         madvise(area, VP_tamanho, MADV_SEQUENTIAL);
+         VP_buffer = (char *) area;
+         VP_mapeado = true;
+      }
+   }
+
+   if (!VP_mapeado)
+   {
+      VP_buffer = (char *) malloc(VP_tamanho + 1);
+      if ((VP_buffer == NULL)||(read(fd, VP_buffer, VP_tamanho) != (ssize_t) VP_tamanho))
+      {
+         close(fd);
+         fecha();
+         return false;
+      }
+      VP_buffer[VP_tamanho] = '\0';
+   }
+   close(fd);
+
+   VP_pos = VP_buffer;
+   VP_fim = VP_buffer + VP_tamanho;
+   return true;
+}
+
+void TLeitor::abreTrecho (TLeitor &origem, const char *inicio, const char *fim)
+{
+   fecha();
+
+   if (fim > origem.VP_fim) fim = origem.VP_fim;
+   if (inicio > fim) inicio = fim;
+
+   //O '\0' do buffer de origem continua depois de fim
+   VP_buffer = (char *) inicio;
+   VP_tamanho = fim-inicio;
+   VP_dono = false;
+   VP_pos = inicio;
+   VP_fim = fim;
+}
+
+void TLeitor::fecha ()
+{
+   if (VP_dono)
+   {
+      if (VP_mapeado) munmap(VP_buffer, VP_tamanho);
+      else            free (VP_buffer);
+   }
+   VP_buffer = NULL;
+   VP_tamanho = 0;
+   VP_mapeado = false;
+   VP_dono = true;
+   VP_pos = NULL;
+   VP_fim = NULL;
+}
+
+bool TLeitor::fimArquivo () { return VP_pos>=VP_fim; }
+
+void TLeitor::pulaEspacos ()
+{
+   while ((VP_pos<VP_fim)&&isEspaco(*VP_pos)) VP_pos++;
+}
+
+void TLeitor::pulaEspacosLinha ()
+{
+   while ((VP_pos<VP_fim)&&((*VP_pos==' ')||(*VP_pos=='\t')||(*VP_pos=='\r'))) VP_pos++;
+}
+
+void TLeitor::pulaLinha ()
+{
+   while ((VP_pos<VP_fim)&&(*VP_pos!='\n')) VP_pos++;
+   if (VP_pos<VP_fim) VP_pos++;
+}
+
+bool TLeitor::pulaCaractere (char c)
+{
+   pulaEspacosLinha();
+   if ((VP_pos<VP_fim)&&(*VP_pos==c))
+   {
+      VP_pos++;
+      return true;
+   }
+   return false;
+}
+
+bool TLeitor::lePalavra (std::string &palavra)
+{
+   pulaEspacos();
+
+   const char *inicio = VP_pos;
+   while ((VP_pos<VP_fim)&&(!isEspaco(*VP_pos))&&(*VP_pos!=':')) VP_pos++;
+
+   palavra.assign(inicio, VP_pos-inicio);
+   return VP_pos>inicio;
+}
+
+bool TLeitor::leLinha (std::string &linha)
+{
+   pulaEspacosLinha();
+
+   const char *inicio = VP_pos;
+   while ((VP_pos<VP_fim)&&(*VP_pos!='\n')) VP_pos++;
+
+   const char *fim = VP_pos;
+   while ((fim>inicio)&&isEspaco(fim[-1])) fim--;
+   if (VP_pos<VP_fim) VP_pos++;
+
+   linha.assign(inicio, fim-inicio);
+   return fim>inicio;
+}
+
+bool TLeitor::leNumero (double &valor)
+{
+   pulaEspacos();
+
+   const char *p = VP_pos;
+   bool negativo = false;
+   uint64_t mantissa = 0;
+   int digitos = 0;
+   int expoente = 0;
+   bool achou = false;
+
+   if ((*p=='-')||(*p=='+')) negativo = (*p++=='-');
+
+   for (; isDigito(*p); p++, achou = true)
+   {
+      if (digitos<19)
+      {
+         mantissa = mantissa*10 + (*p-'0');
+         if (mantissa) digitos++;
+      }
+      else expoente++;
+   }
+
+   if (*p=='.')
+   {
+      for (p++; isDigito(*p); p++, achou = true)
+      {
+         if (digitos<19)
+         {
+            mantissa = mantissa*10 + (*p-'0');
+            if (mantissa) digitos++;
+            expoente--;
+         }
+      }
+   }
+
+   if (!achou) return false;
+
+   if ((*p=='e')||(*p=='E'))
+   {
+      const char *q = p+1;
+      bool expNegativo = false;
+      int exp = 0;
+
+      if ((*q=='-')||(*q=='+')) expNegativo = (*q++=='-');
+      if (isDigito(*q))
+      {
+         for (; isDigito(*q); q++)
+            if (exp<10000) exp = exp*10 + (*q-'0');
+         expoente += expNegativo?-exp:exp;
+         p = q;
+      }
+   }
+
+   //Até 15 dígitos a mantissa é exata e uma única multiplicação
+   //ou divisão por potência exata de 10 já dá o valor arredondado
+   if ((digitos<=15)&&(expoente>=-22)&&(expoente<=22))
+   {
+      double v = (double) mantissa;
+      v = (expoente<0)?v/potencias10[-expoente]:v*potencias10[expoente];
+      valor = negativo?-v:v;
+   }
+   else
+   {
+      char *fim;
+      valor = strtod(VP_pos, &fim);
+      p = fim;
+   }
+
+   VP_pos = p;
+   return true;
+}
+
+bool TLeitor::leInteiro (long &valor)
+{
+   pulaEspacos();
+
+   const char *p = VP_pos;
+   bool negativo = false;
+   long v = 0;
+
+   if ((*p=='-')||(*p=='+')) negativo = (*p++=='-');
+   if (!isDigito(*p)) return false;
+
+   for (; isDigito(*p); p++) v = v*10 + (*p-'0');
+
+   valor = negativo?-v:v;
+   VP_pos = p;
+   return true;
+}
+
+const char *TLeitor::procura (const char *texto, const char *limite)
+{
+   if ((limite == NULL)||(limite > VP_fim)) limite = VP_fim;
+   if (VP_pos >= limite) return NULL;
+
+   return (const char *) memmem(VP_pos, limite-VP_pos, texto, strlen(texto));
+}
+
+const char *TLeitor::get_posicao () { return VP_pos; }
+void TLeitor::set_posicao (const char *posicao) { VP_pos = posicao; }
+const char *TLeitor::get_inicio () { return VP_buffer; }
+const char *TLeitor::get_fim () { return VP_fim; }
+size_t TLeitor::get_tamanho () { return VP_tamanho; }
@@ -0,0 +1,81 @@
+/*
+*  leitor.hpp
+*
+*  Módulo responsável pela leitura sequencial dos arquivos de instância
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _LEITOR_H
+#define	_LEITOR_H
+
+#include <cstddef>
+#include <string>
+
+/*******************************************************
+classe de TLeitor. Mapeia o arquivo (mmap) e o percorre em
+uma só passada. As páginas lidas ficam no cache do sistema
+e podem ser descartadas a qualquer momento, então a memória
+do processo não cresce com o tamanho do arquivo.
+O buffer sempre termina em '\0': o mmap completa a última
+página com zeros e, quando o arquivo ocupa páginas inteiras,
+o arquivo é lido para a memória com um '\0' no final.
+A leitura de números não aloca memória e não depende do
+locale. Números com mais de 15 dígitos significativos ou
+expoentes grandes são repassados ao strtod.
+********************************************************/
+class TLeitor
+{
+   private:
+      char *VP_buffer;
+      size_t VP_tamanho;
+      bool VP_mapeado;
+      bool VP_dono;               //Falso nos trechos abertos com abreTrecho
+      const char *VP_pos;
+      const char *VP_fim;
+
+   public:
+      TLeitor ();
+      ~TLeitor ();
+
+      bool abre (const char *nomeArquivo);
+      //Leitura independente de um trecho do buffer de outro leitor,
+      //para dividir o arquivo entre threads. O trecho não é copiado
+      void abreTrecho (TLeitor &origem, const char *inicio, const char *fim);
+      void fecha ();
+
+      bool fimArquivo ();
+
+      //Espaços, tabulações e quebras de linha
+      void pulaEspacos ();
+      //Espaços e tabulações, sem passar para a próxima linha
+      void pulaEspacosLinha ();
+      void pulaLinha ();
+      //Consome o caractere, se for o próximo da linha após os espaços
+      bool pulaCaractere (char c);
+
+      //Palavra terminada por espaço, quebra de linha ou ':'
+      bool lePalavra (std::string &palavra);
+      //Restante da linha, sem os espaços das pontas
+      bool leLinha (std::string &linha);
+
+      bool leNumero (double &valor);
+      bool leInteiro (long &valor);
+
+      //Próxima ocorrência do texto a partir da posição atual, sem
+      //passar de limite (NULL é o fim do arquivo). Não move a leitura
+      const char *procura (const char *texto, const char *limite = NULL);
+
+      //Posição no buffer, para leituras que voltam ou saltam trechos
+      const char *get_posicao ();
+      void set_posicao (const char *posicao);
+      const char *get_inicio ();
+      const char *get_fim ();
+      size_t get_tamanho ();
+};
+
+#endif	/* _LEITOR_H */
@@ -57,7 +57,7 @@ int main(int argc, char *argv[])
    if (argc < 4)
    {
       cout << "Parâmetros obrigatóros:" << endl;
-      cout << "\t 1 - Arquivo de instância TSP, no formato XML" << endl;
+      cout << "\t 1 - Arquivo de instância TSP, no formato XML ou TSPLIB (.tsp/.atsp)" << endl;
       cout << "\t 2 - Arquivo de configuração, no formato XML" << endl;
       cout << "\t 3 - Nome do arquivo de saída, resultados" << endl;
       return 1;
@@ -70,8 +70,26 @@ int main(int argc, char *argv[])
    cout << "Arquivo " << argv[2] << " carregado." << endl;
 
    cout << "Caregando instância " << argv[1] << endl;
+   mapa->set_armazenamento(config->armazenamento);
+   mapa->set_usaCache(config->cacheInstancia);
+   mapa->set_renumeracao(config->renumeracao);
    mapa->carregaDoArquivo (argv[1]);
-   cout << "Instância " << argv[1] << " carregada." << endl;
+   if (mapa->get_qtdeGenes() <= 0)
+   {
+      cout << "Não foi possível carregar a instância " << argv[1] << endl;
+      delete config;
+      delete mapa;
+      return 1;
+   }
+   cout << "Instância " << argv[1] << " carregada" << (mapa->is_mapeado()?" do cache.":".") << endl;
+   cout << "Distâncias em " << mapa->get_nomeArmazenamento() << ((mapa->is_simetrico()&&!mapa->is_coordenadas())?", matriz simétrica":"") << " (" << mapa->get_tamanhoTabela() << " bytes)" << endl;
+
+   if (mapa->is_renumerado())
+      cout << "Cidades renumeradas " << (mapa->is_coordenadas()?"pela curva de Hilbert":"pelo vizinho mais próximo") << endl;
+
+   mapa->geraCandidatos(config->qtdeCandidatos, config->candidatosQuadrante);
+   if (mapa->get_qtdeCandidatos() > 0)
+      cout << "Listas de " << mapa->get_qtdeCandidatos() << " candidatos por cidade" << endl;
 
    TUtils::initRnd ();
 
@@ -156,6 +174,50 @@ int main(int argc, char *argv[])
       cabecalho  += to_string(config->selIndMutacao);
       cabecalho  += "\n";
 
+      cabecalho  += "Armazenamento das Distâncias;";
+      cabecalho  += mapa->get_nomeArmazenamento();
+      cabecalho  += "\n";
+
+      cabecalho  += "Matriz Simétrica;";
+      cabecalho  += to_string(mapa->is_simetrico());
+      cabecalho  += "\n";
+
+      cabecalho  += "Candidatos por Cidade;";
+      cabecalho  += to_string(mapa->get_qtdeCandidatos());
+      cabecalho  += "\n";
+
+      cabecalho  += "Candidatos por Quadrante;";
+      cabecalho  += to_string(config->candidatosQuadrante);
+      cabecalho  += "\n";
+
+      cabecalho  += "Rota Inicial;";
+      cabecalho  += to_string(config->rotaInicial);
+      cabecalho  += "\n";
+
+      cabecalho  += "Renumeração;";
+      cabecalho  += to_string(mapa->is_renumerado());
+      cabecalho  += "\n";
+
+      cabecalho  += "Mínimo para Lista de Dois Níveis;";
+      cabecalho  += to_string(config->minDoisNiveis);
+      cabecalho  += "\n";
+
+      cabecalho  += "Cache de Reduzidos;";
+      cabecalho  += to_string(config->tamCacheReduzidos);
+      cabecalho  += "\n";
+
+      cabecalho  += "Threads;";
+      cabecalho  += to_string(config->numThreads);
+      cabecalho  += "\n";
+
+      cabecalho  += "Tempo Máximo;";
+      cabecalho  += to_string(config->tempoMaximo);
+      cabecalho  += "\n";
+
+      cabecalho  += "Máximo de Avaliações (milhares);";
+      cabecalho  += to_string(config->maxAvaliacoes);
+      cabecalho  += "\n";
+
       arqSaida = new TArqLog(cabecalho, nomeArqSaida);
       ag = new TAlgGenetico(mapa, arqSaida);
       ag->setMutacao(config->mutacao);
@@ -170,6 +232,12 @@ int main(int argc, char *argv[])
       ag->setSelIndMutacao(config->selIndMutacao);
       ag->setPercentMutacaoRecursiva(config->percentMutacaoRecursiva);
       ag->setPercentReducao(config->percentReducao);
+      ag->setRotaInicial(config->rotaInicial);
+      ag->setMinDoisNiveis(config->minDoisNiveis);
+      ag->setTamCacheReduzidos(config->tamCacheReduzidos);
+      ag->setNumThreads(config->numThreads);
+      ag->setTempoMaximo(config->tempoMaximo);
+      ag->setMaxAvaliacoes(config->maxAvaliacoes);
       ag->exec();
 
       arqSaida->addLinha("");
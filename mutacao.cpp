@@ -17,11 +17,12 @@
 TMapaGenes *TMutacao::getMapa() { return VP_Mapa; }
 TArqLog *TMutacao::getArqLog()  { return VP_ArqSaida; }
 
-TMutacao::TMutacao (TMapaGenes *mapa, TArqLog *arqSaida, int tipoMutacao)
+TMutacao::TMutacao (TMapaGenes *mapa, TArqLog *arqSaida, int tipoMutacao, int minDoisNiveis)
 {
    VP_Mapa = mapa;
    VP_ArqSaida = arqSaida;
    VP_mutacao = tipoMutacao;
+   VP_minDoisNiveis = minDoisNiveis;
 }
 
 int TMutacao::processa (TIndividuo *individuo)
@@ -63,6 +64,11 @@ int TMutacao::processa (TIndividuo *individuo)
          return SIM(individuo);
          break;
       }
+      case 19:
+      {
+         return twoOPTVizinhos(individuo);
+         break;
+      }
       default:
       {
          break;
@@ -265,8 +271,8 @@ int TMutacao::threeOPT(TIndividuo *individuo)
                             VP_Mapa->get_distancia(gJmas1->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato + 
-				       this->calcValReverso(gImas1, gj) +
-				       this->calcValReverso(gJmas1, gk);
+				       this->calcValReverso(individuo, gImas1, gj) +
+				       this->calcValReverso(individuo, gJmas1, gk);
 
             if(min > diff)
             {
@@ -299,7 +305,7 @@ int TMutacao::threeOPT(TIndividuo *individuo)
                             VP_Mapa->get_distancia(gj->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato +
-                   this->calcValReverso(gJmas1, gk);
+                   this->calcValReverso(individuo, gJmas1, gk);
 
             if(min > diff)
             {
@@ -316,7 +322,7 @@ int TMutacao::threeOPT(TIndividuo *individuo)
                             VP_Mapa->get_distancia(gImas1->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato +
-				       this->calcValReverso(gImas1, gj);
+				       this->calcValReverso(individuo, gImas1, gj);
 
             if(min > diff)
             {
@@ -423,8 +429,8 @@ int TMutacao::threeOPT2(TIndividuo *individuo)
 
 
             diff = valor - gainActual + gainCandidato + 
-			          this->calcValReverso(gImas1, gj) +
-				       this->calcValReverso(gJmas1, gk);
+			          this->calcValReverso(individuo, gImas1, gj) +
+				       this->calcValReverso(individuo, gJmas1, gk);
 
             if(min > diff)
             {
@@ -451,7 +457,7 @@ int TMutacao::threeOPT2(TIndividuo *individuo)
                             VP_Mapa->get_distancia(gj->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato +
-                   this->calcValReverso(gJmas1, gk);
+                   this->calcValReverso(individuo, gJmas1, gk);
 				   
             if(min > diff)
             {
@@ -465,7 +471,7 @@ int TMutacao::threeOPT2(TIndividuo *individuo)
                             VP_Mapa->get_distancia(gImas1->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato +
-                   this->calcValReverso(gImas1, gj);
+                   this->calcValReverso(individuo, gImas1, gj);
 
             if(min > diff)
             {
@@ -509,16 +515,186 @@ int TMutacao::threeOPT2(TIndividuo *individuo)
    return individuo->get_extra()^1;
 }
 
+/**
+ *
+ * 2-opt restrito aos vizinhos
+ *
+ * Bentley (1992). Fast Algorithms for Geometric Traveling Salesman
+ * Problems. ORSA Journal on Computing, 4(4), 387–411.
+ *
+ * Só são testadas as arestas (a,c) com c na lista de candidatos de a e
+ * mais curtas do que uma das arestas atuais de a. Cada passada custa
+ * O(n.k) em vez de O(n²). Vale para indivíduos com as cidades do mapa
+ * e matriz simétrica; nos demais casos é feito o 2-opt(2)
+ *
+ **/
+int TMutacao::twoOPTVizinhos(TIndividuo *individuo)
+{
+   int qtdeCandidatos = VP_Mapa->get_qtdeCandidatos();
+   if ((qtdeCandidatos==0)||(!individuo->is_completo())||(!individuo->is_simetrico()))
+      return twoOPT2(individuo);
+
+   if (individuo->get_extra()) return 0;
+   if (individuo->get_qtdeGenes()<4) return 0;
+
+   //Nas instâncias grandes a inversão no vetor do indivíduo custa O(n)
+   if ((VP_minDoisNiveis>0)&&(individuo->get_qtdeGenes()>=VP_minDoisNiveis))
+      return twoOPTVizinhosDoisNiveis(individuo);
+
+   double dist = individuo->get_distancia();
+   bool melhorou = true;
+
+   while (melhorou)
+   {
+      melhorou = false;
+      for (int a = 0; a < individuo->get_qtdeGenes(); a++)
+      {
+         TGene *ga = individuo->get_por_id(a);
+         const int *candidatos = VP_Mapa->get_candidatos(a);
+
+         for (int k = 0; k < qtdeCandidatos; k++)
+         {
+            TGene *gc = individuo->get_por_id(candidatos[k]);
+            double dac = VP_Mapa->get_distancia(a, gc->id);
+            bool sucessor = dac < VP_Mapa->get_distancia(a, individuo->prox(ga)->id);
+            bool antecessor = dac < VP_Mapa->get_distancia(individuo->ant(ga)->id, a);
+
+            //A lista está em ordem, então os próximos também não servem
+            if (!sucessor && !antecessor) break;
+
+            //a-c e sucessores: remove (a,a+1),(c,c+1), inclui (a,c),(a+1,c+1)
+            //a-c e antecessores: remove (a-1,a),(c-1,c), inclui (a-1,c-1),(a,c)
+            if ((sucessor && tentaDoisOpt(individuo, ga, gc)) ||
+                (antecessor && tentaDoisOpt(individuo, individuo->ant(ga), individuo->ant(gc))))
+            {
+               melhorou = true;
+               break;
+            }
+         }
+      }
+   }
+
+   individuo->set_extra((dist == individuo->get_distancia())?1:0);
+   return individuo->get_extra()^1;
+}
+
+/**
+ *
+ * 2-opt restrito aos vizinhos, na lista de dois níveis
+ *
+ * Fredman, Johnson, McGeoch & Ostheimer (1995). Data Structures for
+ * Traveling Salesmen. Journal of Algorithms, 18(3), 432–479.
+ *
+ * A mesma busca do 2-opt restrito aos vizinhos, com a rota copiada para
+ * uma lista de dois níveis, onde cada inversão custa O(raiz(n)). A rota
+ * volta para o indivíduo só no final, se tiver melhorado
+ *
+ **/
+int TMutacao::twoOPTVizinhosDoisNiveis(TIndividuo *individuo)
+{
+   int qtde = individuo->get_qtdeGenes();
+   int qtdeCandidatos = VP_Mapa->get_qtdeCandidatos();
+   vector<int> rota(qtde);
+   bool alterou = false;
+   bool melhorou = true;
+
+   for (int i = 0; i < qtde; i++) rota[i] = individuo->get_por_indice(i)->id;
+   VP_rota.carrega(&rota[0], qtde);
+
+   while (melhorou)
+   {
+      melhorou = false;
+      for (int a = 0; a < qtde; a++)
+      {
+         const int *candidatos = VP_Mapa->get_candidatos(a);
+
+         for (int k = 0; k < qtdeCandidatos; k++)
+         {
+            int c = candidatos[k];
+            double dac = VP_Mapa->get_distancia(a, c);
+            bool sucessor = dac < VP_Mapa->get_distancia(a, VP_rota.prox(a));
+            bool antecessor = dac < VP_Mapa->get_distancia(VP_rota.ant(a), a);
+
+            if (!sucessor && !antecessor) break;
+
+            if ((sucessor && tentaDoisOpt(VP_rota, a, c)) ||
+                (antecessor && tentaDoisOpt(VP_rota, VP_rota.ant(a), VP_rota.ant(c))))
+            {
+               melhorou = true;
+               alterou = true;
+               break;
+            }
+         }
+      }
+   }
+
+   if (alterou)
+   {
+      VP_rota.get_rota(&rota[0]);
+      individuo->set_rota(&rota[0]);
+   }
+
+   individuo->set_extra(alterou?0:1);
+   return individuo->get_extra()^1;
+}
+
 /*************************
 *  Métodos auxiliares
 *************************/
-double TMutacao::calcValReverso (TGene *g1, TGene *g2)
+
+//Troca as arestas (x,x+1) e (z,z+1) por (x,z) e (x+1,z+1), se diminuir a
+//rota. Inverte o trecho que não contém o gene 0, que é fixo
+bool TMutacao::tentaDoisOpt (TIndividuo *individuo, TGene *x, TGene *z)
+{
+   TGene *y = individuo->prox(x);
+   TGene *w = individuo->prox(z);
+
+   if ((z == x) || (z == y) || (w == x)) return false;
+
+   double ganho = VP_Mapa->get_distancia(x->id, y->id) + VP_Mapa->get_distancia(z->id, w->id)
+                - VP_Mapa->get_distancia(x->id, z->id) - VP_Mapa->get_distancia(y->id, w->id);
+   if (ganho <= 1e-9) return false;
+
+   int iy = individuo->get_indice(y);
+   int iz = individuo->get_indice(z);
+
+   if ((iy != 0) && (iy <= iz)) individuo->inverte_sub_indice(iy, iz);
+   else                         individuo->inverte_sub_indice(individuo->get_indice(w), individuo->get_indice(x));
+   return true;
+}
+
+//O mesmo movimento na lista de dois níveis, onde não há gene fixo
+bool TMutacao::tentaDoisOpt (TRotaDoisNiveis &rota, int x, int z)
+{
+   int y = rota.prox(x);
+   int w = rota.prox(z);
+
+   if ((z == x) || (z == y) || (w == x)) return false;
+
+   double ganho = VP_Mapa->get_distancia(x, y) + VP_Mapa->get_distancia(z, w)
+                - VP_Mapa->get_distancia(x, z) - VP_Mapa->get_distancia(y, w);
+   if (ganho <= 1e-9) return false;
+
+   rota.inverte(y, z);
+   return true;
+}
+
+double TMutacao::calcValReverso (TIndividuo *individuo, TGene *g1, TGene *g2)
 {
 	double resultado = 0;
-	for (TGene *aux = g1; aux->id != g2->id; aux = aux->prox)
+
+	//Na matriz simétrica, inverter o trecho não altera seu custo interno
+	if (individuo->is_simetrico()) return resultado;
+
+	//Percorre pela posição, sem ir ao id de cada gene
+	int fim = individuo->get_indice(g2);
+	TGene *aux = g1, *prox;
+	for (int i = individuo->get_indice(g1), p; i != fim; i = p, aux = prox)
 	{
-		resultado -= VP_Mapa->get_distancia(aux->ori, aux->prox->dest);
-		resultado += VP_Mapa->get_distancia(aux->prox->ori, aux->dest);
+		p = individuo->ind_prox(i);
+		prox = individuo->get_por_indice(p);
+		resultado -= VP_Mapa->get_distancia(aux->ori, prox->dest);
+		resultado += VP_Mapa->get_distancia(prox->ori, aux->dest);
 	}
 	
 	return resultado;
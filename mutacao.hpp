@@ -18,6 +18,7 @@
 #include "utils.hpp"
 #include "tsp.hpp"
 #include "arqlog.hpp"
+#include "rotadoisniveis.hpp"
 
 class TMutacao
 {
@@ -26,6 +27,8 @@ class TMutacao
       TArqLog *VP_ArqSaida;
 
       int VP_mutacao;
+      int VP_minDoisNiveis;       //Cidades a partir das quais o 2-opt usa a lista de dois níveis, 0 desliga
+      TRotaDoisNiveis VP_rota;
    public:
 
       //Apenas leitura
@@ -33,7 +36,7 @@ class TMutacao
       TArqLog *getArqLog();
 
 
-      TMutacao (TMapaGenes *mapa, TArqLog *arqSaida, int tipoMutacao);
+      TMutacao (TMapaGenes *mapa, TArqLog *arqSaida, int tipoMutacao, int minDoisNiveis);
       int processa (TIndividuo *individuo);
 
    private:
@@ -45,9 +48,13 @@ class TMutacao
       int SIM(TIndividuo *individuo);
       int threeOPT(TIndividuo *individuo);
       int threeOPT2(TIndividuo *individuo);
+      int twoOPTVizinhos(TIndividuo *individuo);
+      int twoOPTVizinhosDoisNiveis(TIndividuo *individuo);
 	  
 	  //Métodos auxiliares
-	  double calcValReverso (TGene *g1, TGene *g2);
+	  double calcValReverso (TIndividuo *individuo, TGene *g1, TGene *g2);
+	  bool tentaDoisOpt (TIndividuo *individuo, TGene *x, TGene *z);
+	  bool tentaDoisOpt (TRotaDoisNiveis &rota, int x, int z);
 };
 
 #endif
@@ -0,0 +1,172 @@
+/*
+*  orcamento.cpp
+*
+*  Módulo responsável pelo orçamento de esforço do AG recursivo
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "orcamento.hpp"
+#include <cmath>
+
+TOrcamento::TOrcamento (double tempoMaximo, unsigned long maxAvaliacoes, int profundidadeMaxima)
+{
+   VP_tempoMaximo = tempoMaximo;
+   VP_maxAvaliacoes = maxAvaliacoes;
+   VP_inicio = chrono::steady_clock::now();
+   VP_pai = NULL;
+
+   VP_qtdeProfundidades = ((profundidadeMaxima>0)?profundidadeMaxima:0) + 1;
+   VP_estatisticas.assign(VP_qtdeProfundidades*qtdeFaixas, TEstatistica());
+   VP_avaliacoes.assign(VP_qtdeProfundidades, 0);
+}
+
+TOrcamento::TOrcamento (const TOrcamento *pai)
+{
+   VP_tempoMaximo = pai->VP_tempoMaximo;
+   VP_maxAvaliacoes = pai->VP_maxAvaliacoes;
+   VP_inicio = pai->VP_inicio;
+   VP_pai = pai;
+
+   VP_qtdeProfundidades = pai->VP_qtdeProfundidades;
+   VP_estatisticas.assign(VP_qtdeProfundidades*qtdeFaixas, TEstatistica());
+   VP_avaliacoes.assign(VP_qtdeProfundidades, 0);
+}
+
+bool TOrcamento::is_limitado () { return (VP_tempoMaximo>0)||(VP_maxAvaliacoes>0); }
+
+double TOrcamento::get_tempo ()
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - VP_inicio).count();
+}
+
+unsigned long TOrcamento::get_totalAvaliacoes () const
+{
+   unsigned long total = 0;
+   for (const TOrcamento *o=this; o; o=o->VP_pai)
+      for (int p=0; p<VP_qtdeProfundidades; p++) total += o->VP_avaliacoes[p];
+   return total;
+}
+
+unsigned long TOrcamento::get_avaliacoes () { return get_totalAvaliacoes(); }
+
+bool TOrcamento::is_esgotado ()
+{
+   if ((VP_maxAvaliacoes>0)&&(get_totalAvaliacoes()>=VP_maxAvaliacoes)) return true;
+   return (VP_tempoMaximo>0)&&(get_tempo()>=VP_tempoMaximo);
+}
+
+TOrcamento::TEstatistica TOrcamento::get_estatistica (int profundidade, int faixa) const
+{
+   TEstatistica total = TEstatistica();
+   for (const TOrcamento *o=this; o; o=o->VP_pai)
+   {
+      const TEstatistica &e = o->VP_estatisticas[profundidade*qtdeFaixas + faixa];
+      total.execucoes  += e.execucoes;
+      total.melhorias  += e.melhorias;
+      total.ganho      += e.ganho;
+      total.avaliacoes += e.avaliacoes;
+      total.tempo      += e.tempo;
+   }
+   return total;
+}
+
+int TOrcamento::get_faixa (int qtdeReduzido, int qtdeGenes)
+{
+   int faixa = (qtdeGenes>0)?qtdeReduzido*qtdeFaixas/qtdeGenes:0;
+   if (faixa<0) return 0;
+   return (faixa<qtdeFaixas)?faixa:qtdeFaixas-1;
+}
+
+int TOrcamento::get_geracoes (int profundidade, int faixa, int maxGeracao)
+{
+   if ((!is_limitado())||(profundidade>=VP_qtdeProfundidades)) return maxGeracao;
+
+   TEstatistica e = get_estatistica(profundidade, faixa);
+   if (e.execucoes<(unsigned long)minAmostras) return maxGeracao;
+
+   //Melhor ganho por avaliação entre as faixas já conhecidas
+   double melhor = 0;
+   for (int p=1; p<VP_qtdeProfundidades; p++)
+      for (int f=0; f<qtdeFaixas; f++)
+      {
+         TEstatistica o = get_estatistica(p, f);
+         if ((o.execucoes>=(unsigned long)minAmostras)&&(o.avaliacoes>0)&&(o.ganho/o.avaliacoes>melhor))
+            melhor = o.ganho/o.avaliacoes;
+      }
+
+   double fator = ((melhor>0)&&(e.avaliacoes>0))?(e.ganho/e.avaliacoes)/melhor:0;
+   int geracoes = (int) lround(maxGeracao*fator);
+   return (geracoes<1)?1:geracoes;
+}
+
+void TOrcamento::consome (int profundidade, unsigned long avaliacoes)
+{
+   if (profundidade>=VP_qtdeProfundidades) profundidade = VP_qtdeProfundidades-1;
+   VP_avaliacoes[profundidade] += avaliacoes;
+}
+
+void TOrcamento::registra (int profundidade, int faixa, double ganho, unsigned long avaliacoes, double tempo)
+{
+   if (profundidade>=VP_qtdeProfundidades) return;
+
+   TEstatistica &e = VP_estatisticas[profundidade*qtdeFaixas + faixa];
+   e.execucoes++;
+   if (ganho>0) e.melhorias++;
+   e.ganho      += ganho;
+   e.avaliacoes += avaliacoes;
+   e.tempo      += tempo;
+}
+
+void TOrcamento::incorpora (const TOrcamento &tarefa)
+{
+   for (unsigned i=0; i<VP_estatisticas.size(); i++)
+   {
+      VP_estatisticas[i].execucoes  += tarefa.VP_estatisticas[i].execucoes;
+      VP_estatisticas[i].melhorias  += tarefa.VP_estatisticas[i].melhorias;
+      VP_estatisticas[i].ganho      += tarefa.VP_estatisticas[i].ganho;
+      VP_estatisticas[i].avaliacoes += tarefa.VP_estatisticas[i].avaliacoes;
+      VP_estatisticas[i].tempo      += tarefa.VP_estatisticas[i].tempo;
+   }
+   for (int p=0; p<VP_qtdeProfundidades; p++) VP_avaliacoes[p] += tarefa.VP_avaliacoes[p];
+}
+
+string TOrcamento::toString ()
+{
+   string resultado = "";
+   for (int p=0; p<VP_qtdeProfundidades; p++)
+   {
+      TEstatistica total = TEstatistica();
+      for (int f=0; f<qtdeFaixas; f++)
+      {
+         TEstatistica e = get_estatistica(p, f);
+         total.execucoes  += e.execucoes;
+         total.melhorias  += e.melhorias;
+         total.ganho      += e.ganho;
+         total.avaliacoes += e.avaliacoes;
+         total.tempo      += e.tempo;
+      }
+
+      resultado += "Orçamento;Profundidade;";
+      resultado += to_string(p);
+      resultado += ";Avaliações;";
+      resultado += to_string(VP_avaliacoes[p]);
+      if (p>0)
+      {
+         resultado += ";Execuções;";
+         resultado += to_string(total.execucoes);
+         resultado += ";Melhorias;";
+         resultado += to_string(total.melhorias);
+         resultado += ";Ganho;";
+         resultado += to_string(total.ganho);
+         resultado += ";Tempo;";
+         resultado += to_string(total.tempo);
+      }
+      resultado += "\n";
+   }
+   return resultado;
+}
@@ -0,0 +1,101 @@
+/*
+*  orcamento.hpp
+*
+*  Módulo responsável pelo orçamento de esforço do AG recursivo
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _ORCAMENTO_H
+#define	_ORCAMENTO_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+using namespace std;
+
+/*******************************************************
+classe de TOrcamento. Limita o esforço de uma execução,
+em tempo (segundos) e/ou em avaliações (indivíduos gerados
+em todas as profundidades), e guarda, por profundidade e
+por faixa de redução, quanto cada AG recursivo custou e
+quanto melhorou os indivíduos.
+
+Sem limites, só faz as contas para o relatório. Com algum
+limite, a execução principal e os AGs recursivos param
+quando ele acaba, e cada AG recursivo recebe uma parte das
+gerações proporcional ao ganho por avaliação da sua
+profundidade e faixa, comparado com a melhor delas. Faixas
+ainda com poucas execuções recebem todas as gerações, e
+nenhuma fica com menos de uma, para que as estimativas
+continuem sendo atualizadas.
+
+Nas tarefas paralelas cada tarefa tem o seu orçamento,
+sobre o da geração (pai), que só é lido durante as tarefas.
+As decisões usam as contas do pai mais as da tarefa, e os
+orçamentos das tarefas são incorporados em ordem no final.
+Com o limite em avaliações o resultado não depende da
+quantidade de threads. As tarefas de uma geração não veem
+o consumo umas das outras, e o limite pode ser ultrapassado
+em até uma geração de tarefas.
+********************************************************/
+class TOrcamento
+{
+   private:
+      struct TEstatistica
+      {
+         unsigned long execucoes;
+         unsigned long melhorias;
+         double ganho;              //Soma das reduções de distância
+         unsigned long avaliacoes;  //Incluindo as dos níveis internos
+         double tempo;              //Segundos, incluindo os níveis internos
+      };
+
+      static const int qtdeFaixas = 10;   //Faixas de 10% da redução
+      static const int minAmostras = 5;   //Execuções antes de confiar no ganho
+
+      double VP_tempoMaximo;
+      unsigned long VP_maxAvaliacoes;
+      chrono::steady_clock::time_point VP_inicio;
+      const TOrcamento *VP_pai;           //Somente leitura, NULL no principal
+
+      int VP_qtdeProfundidades;
+      vector<TEstatistica> VP_estatisticas;   //profundidade*qtdeFaixas + faixa
+      vector<unsigned long> VP_avaliacoes;    //Avaliações feitas em cada profundidade
+
+      //Soma deste orçamento e dos pais
+      TEstatistica get_estatistica (int profundidade, int faixa) const;
+      unsigned long get_totalAvaliacoes () const;
+
+   public:
+      //tempoMaximo e maxAvaliacoes 0 não limitam
+      TOrcamento (double tempoMaximo, unsigned long maxAvaliacoes, int profundidadeMaxima);
+      //Orçamento de uma tarefa paralela
+      TOrcamento (const TOrcamento *pai);
+
+      bool is_limitado ();
+      bool is_esgotado ();
+      double get_tempo ();                    //Desde o início da execução principal
+      unsigned long get_avaliacoes ();        //Consumidas, incluindo as dos pais
+
+      //Faixa de redução do indivíduo reduzido de qtdeReduzido genes
+      static int get_faixa (int qtdeReduzido, int qtdeGenes);
+      //Gerações para um AG recursivo da profundidade e faixa
+      int get_geracoes (int profundidade, int faixa, int maxGeracao);
+
+      void consome (int profundidade, unsigned long avaliacoes);
+      void registra (int profundidade, int faixa, double ganho, unsigned long avaliacoes, double tempo);
+      //Traz as contas do orçamento de uma tarefa
+      void incorpora (const TOrcamento &tarefa);
+
+      //Uma linha por profundidade, para o arquivo de saída
+      string toString ();
+};
+
+#endif	/* _ORCAMENTO_H */
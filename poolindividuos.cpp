@@ -0,0 +1,74 @@
+/*
+*  poolindividuos.cpp
+*
+*  Módulo responsável pela alocação dos indivíduos de uma execução do AG
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "poolindividuos.hpp"
+#include <new>
+
+TPoolIndividuos::TPoolIndividuos (TMapaGenes *mapa, TArqLog *arqSaida, unsigned qtdeBloco)
+{
+   VP_Mapa = mapa;
+   VP_ArqSaida = arqSaida;
+
+   VP_qtdeBloco = (qtdeBloco>0)?qtdeBloco:1;
+   VP_usadosBloco = VP_qtdeBloco;
+}
+
+TPoolIndividuos::~TPoolIndividuos ()
+{
+   //Todos os blocos estão cheios, menos o último
+   for (unsigned b=0; b<VP_blocos.size(); b++)
+   {
+      unsigned qtde = (b+1<VP_blocos.size())?VP_qtdeBloco:VP_usadosBloco;
+      for (unsigned i=0; i<qtde; i++) VP_blocos[b][i].~TIndividuo();
+      ::operator delete (VP_blocos[b]);
+   }
+   VP_blocos.clear();
+   VP_livres.clear();
+}
+
+TIndividuo *TPoolIndividuos::aloca ()
+{
+   lock_guard<mutex> trava(VP_trava);
+
+   if (!VP_livres.empty())
+   {
+      TIndividuo *individuo = VP_livres.back();
+      VP_livres.pop_back();
+      return individuo;
+   }
+
+   if (VP_usadosBloco==VP_qtdeBloco)
+   {
+      VP_blocos.push_back((TIndividuo *) ::operator new (VP_qtdeBloco*sizeof(TIndividuo)));
+      VP_usadosBloco = 0;
+   }
+
+   return new (&VP_blocos.back()[VP_usadosBloco++]) TIndividuo(VP_Mapa, VP_ArqSaida, this);
+}
+
+void TPoolIndividuos::devolve (TIndividuo *individuo)
+{
+   lock_guard<mutex> trava(VP_trava);
+   VP_livres.push_back(individuo);
+}
+
+TIndividuo *TPoolIndividuos::aloca (TPoolIndividuos *pool, TMapaGenes *mapa, TArqLog *arqSaida)
+{
+   if (pool) return pool->aloca();
+   return new TIndividuo(mapa, arqSaida);
+}
+
+void TPoolIndividuos::libera (TIndividuo *individuo)
+{
+   if (individuo->get_pool()) individuo->get_pool()->devolve(individuo);
+   else                       delete individuo;
+}
@@ -0,0 +1,64 @@
+/*
+*  poolindividuos.hpp
+*
+*  Módulo responsável pela alocação dos indivíduos de uma execução do AG
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _POOLINDIVIDUOS_H
+#define	_POOLINDIVIDUOS_H
+
+#include <vector>
+#include <mutex>
+#include "tsp.hpp"
+#include "arqlog.hpp"
+#include "individuo.hpp"
+
+/*******************************************************
+classe de TPoolIndividuos. Os indivíduos são construídos
+em blocos contíguos e, quando saem da população, voltam
+para uma lista de livres em vez de serem destruídos. Um
+indivíduo reaproveitado mantém a memória da sua rota, então
+depois das primeiras gerações clonar e criar filhos não
+aloca mais nada. A memória só é liberada, toda de uma vez,
+quando o pool é destruído.
+
+Os indivíduos passam de uma geração para a outra (elitismo
+e filhos), então o pool é de toda a execução do AG e não
+de uma população. Todos os indivíduos de um pool têm a
+mesma quantidade de genes.
+
+Os filhos de uma geração são criados em várias threads,
+então alocar e devolver passam por uma trava.
+********************************************************/
+class TPoolIndividuos
+{
+   private:
+      TMapaGenes *VP_Mapa;
+      TArqLog *VP_ArqSaida;
+
+      unsigned VP_qtdeBloco;               //Indivíduos por bloco
+      unsigned VP_usadosBloco;             //Já construídos no último bloco
+      vector <TIndividuo *> VP_blocos;
+      vector <TIndividuo *> VP_livres;
+      mutex VP_trava;
+
+   public:
+      TPoolIndividuos (TMapaGenes *mapa, TArqLog *arqSaida, unsigned qtdeBloco);
+      ~TPoolIndividuos ();
+
+      //Indivíduo sem rota. Deve ser criado com novo() ou ser destino de um clone
+      TIndividuo *aloca ();
+      void devolve (TIndividuo *individuo);
+
+      //Alocação e liberação para indivíduos com ou sem pool
+      static TIndividuo *aloca (TPoolIndividuos *pool, TMapaGenes *mapa, TArqLog *arqSaida);
+      static void libera (TIndividuo *individuo);
+};
+
+#endif	/* _POOLINDIVIDUOS_H */
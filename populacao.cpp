@@ -14,6 +14,7 @@
 //Apenas leitura
 TMapaGenes *TPopulacao::getMapa()           { return VP_Mapa; }
 TArqLog *TPopulacao::getArqLog()            { return VP_ArqSaida; }
+TPoolIndividuos *TPopulacao::get_pool()     { return VP_pool; }
 unsigned TPopulacao::get_tamanho()          { return VP_tamanho; }
 unsigned TPopulacao::get_qtdeIndividuo()    { return VP_individuos.size(); }
 double TPopulacao::get_soma_dist ()         { return VP_somaDistancias; }
@@ -39,6 +40,34 @@ void TPopulacao::soma_dist_tot (double val)
 	VP_somaDistanciasInv += 1/val;
 }
 
+void TPopulacao::recalculaSomas (int qtdeThreads)
+{
+   int qtde = VP_individuos.size();
+   int qtdeBlocos = (qtde + tamBlocoSoma - 1) / tamBlocoSoma;
+   vector<double> somas(qtdeBlocos, 0);
+   vector<double> somasInv(qtdeBlocos, 0);
+
+   #pragma omp parallel for schedule(static) num_threads(qtdeThreads) if((qtdeThreads>1)&&(qtdeBlocos>1))
+   for (int b=0; b<qtdeBlocos; b++)
+   {
+      int fim = (b+1)*tamBlocoSoma;
+      if (fim>qtde) fim = qtde;
+      for (int i=b*tamBlocoSoma; i<fim; i++)
+      {
+         somas[b]    += VP_individuos[i]->get_distancia();
+         somasInv[b] += VP_individuos[i]->get_distanciaInv();
+      }
+   }
+
+   VP_somaDistancias = 0;
+	VP_somaDistanciasInv = 0;
+   for (int b=0; b<qtdeBlocos; b++)
+   {
+      VP_somaDistancias += somas[b];
+      VP_somaDistanciasInv += somasInv[b];
+   }
+}
+
 void TPopulacao::add_individuo(TIndividuo *individuo)
 {
    if (VP_individuos.size() < VP_tamanho)
@@ -48,7 +77,7 @@ void TPopulacao::add_individuo(TIndividuo *individuo)
 		VP_somaDistanciasInv += individuo->get_distanciaInv();
    }
    else
-	   delete individuo;
+	   TPoolIndividuos::libera(individuo);
 }
 
 void TPopulacao::add_individuo(vector <TIndividuo *>individuos)
@@ -59,25 +88,36 @@ void TPopulacao::add_individuo(vector <TIndividuo *>individuos)
   individuos.clear(); 
 }
 
-TPopulacao::TPopulacao (int tamanho, TMapaGenes *mapa, TArqLog *arqSaida)
+TPopulacao::TPopulacao (int tamanho, TMapaGenes *mapa, TArqLog *arqSaida, TPoolIndividuos *pool)
 {
    VP_Mapa = mapa;
    VP_ArqSaida = arqSaida;
+   VP_pool = pool;
 
    VP_somaDistancias = 0;
 	VP_somaDistanciasInv = 0;
    VP_tamanho = tamanho;
+   VP_individuos.reserve(tamanho);
 }
 
-void TPopulacao::povoa()
+void TPopulacao::povoa(int rotaInicial)
 {
    TIndividuo *individuo;
 
    for (unsigned i=0; i<VP_tamanho; i++)
    {
-      individuo = new TIndividuo(getMapa(), getArqLog());
-      individuo->novo();
-      individuo->embaralha();
+      individuo = TPoolIndividuos::aloca(VP_pool, getMapa(), getArqLog());
+      if ((i==0)&&(rotaInicial==1))
+      {
+         vector<int> rota(getMapa()->get_qtdeGenes());
+         getMapa()->rotaVizinhoMaisProximo(rota.data());
+         individuo->novo(rota.data());
+      }
+      else
+      {
+         individuo->novo();
+         individuo->embaralha();
+      }
       VP_somaDistancias += individuo->get_distancia();
 		VP_somaDistanciasInv += individuo->get_distanciaInv();
       VP_individuos.push_back(individuo);
@@ -90,7 +130,7 @@ void TPopulacao::povoa(vector<TTipoConversao> tabConv, int extraPadrao)
 
    for (unsigned i=0; i<VP_tamanho; i++)
    {
-      individuo = new TIndividuo(getMapa(), getArqLog());
+      individuo = TPoolIndividuos::aloca(VP_pool, getMapa(), getArqLog());
       individuo->novo(tabConv, extraPadrao);
 	  
 	  //Não embaralha o primeiro individuo
@@ -105,12 +145,20 @@ void TPopulacao::povoa(vector<TTipoConversao> tabConv, int extraPadrao)
 }
 
 TPopulacao::~TPopulacao()
+{
+   esvazia();
+}
+
+void TPopulacao::esvazia()
 {
    for (vector< TIndividuo *>::iterator i=VP_individuos.begin(); i!=VP_individuos.end(); ++i)
    {
-     delete (*i);
+     TPoolIndividuos::libera(*i);
    }
    VP_individuos.clear();
+
+   VP_somaDistancias = 0;
+	VP_somaDistanciasInv = 0;
 }
 
 string TPopulacao::toString ()
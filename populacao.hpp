@@ -14,6 +14,7 @@
 #include "tsp.hpp"
 #include "arqlog.hpp"
 #include "individuo.hpp"
+#include "poolindividuos.hpp"
 #include <vector>
 #include <algorithm>
 
@@ -22,6 +23,8 @@ class TPopulacao
    static int comparaMelhor(const void *Indi, const void *Indj);
 
    private:
+      static const int tamBlocoSoma = 256;   //Indivíduos por soma parcial em recalculaSomas
+
       vector <TIndividuo *> VP_individuos;
 
       double VP_somaDistancias;
@@ -30,23 +33,33 @@ class TPopulacao
 
       TMapaGenes *VP_Mapa;
       TArqLog *VP_ArqSaida;
+      TPoolIndividuos *VP_pool;
 
    public:
       //Apenas leitura
       TMapaGenes *getMapa();
       TArqLog *getArqLog();
+      TPoolIndividuos *get_pool();
       unsigned get_tamanho();
       unsigned get_qtdeIndividuo();
       double get_soma_dist ();
 		double get_soma_distInv ();
       void sub_dist_tot (double val);
       void soma_dist_tot (double val);
+      //Refaz as somas a partir das distâncias dos indivíduos. As parciais são
+      //por blocos fixos, somados em ordem: não dependem da quantidade de threads
+      void recalculaSomas (int qtdeThreads = 1);
 
       //Métodos
-      TPopulacao (int tamanho, TMapaGenes *mapa, TArqLog *arqSaida);
+      //Com pool, os indivíduos são alocados nele e devolvidos a ele
+      TPopulacao (int tamanho, TMapaGenes *mapa, TArqLog *arqSaida, TPoolIndividuos *pool = NULL);
       ~TPopulacao ();
 
-      void povoa();
+      //Libera os indivíduos, mantendo a população para ser preenchida de novo
+      void esvazia ();
+
+      //rotaInicial 1: o primeiro indivíduo é a rota do vizinho mais próximo
+      void povoa(int rotaInicial);
       void povoa(vector<TTipoConversao> tabConv, int extraPadrao);
 
       TIndividuo *get_melhor();
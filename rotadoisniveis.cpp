@@ -0,0 +1,202 @@
+/*
+*  rotadoisniveis.cpp
+*
+*  Módulo responsável pela rota em lista de dois níveis, para a busca local nas instâncias grandes
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "rotadoisniveis.hpp"
+#include <algorithm>
+#include <cmath>
+
+TRotaDoisNiveis::TRotaDoisNiveis ()
+{
+   VP_qtde = 0;
+   VP_tamSegmento = 0;
+}
+
+int TRotaDoisNiveis::get_qtde () const { return VP_qtde; }
+
+int TRotaDoisNiveis::get_indice (int cidade) const
+{
+   const TSegmento &s = VP_segmentos[VP_segCidade[cidade]];
+   return s.invertido?(int)s.cidades.size()-1-VP_posCidade[cidade]:VP_posCidade[cidade];
+}
+
+int TRotaDoisNiveis::get_cidade (int segmento, int indice) const
+{
+   const TSegmento &s = VP_segmentos[segmento];
+   return s.invertido?s.cidades[s.cidades.size()-1-indice]:s.cidades[indice];
+}
+
+void TRotaDoisNiveis::carrega (const int *rota, int qtde)
+{
+   VP_qtde = qtde;
+   VP_tamSegmento = (int) sqrt((double) qtde);
+   if (VP_tamSegmento<8) VP_tamSegmento = 8;
+
+   VP_segCidade.resize(qtde);
+   VP_posCidade.resize(qtde);
+   monta(rota);
+}
+
+void TRotaDoisNiveis::monta (const int *rota)
+{
+   int qtdeSeg = (VP_qtde+VP_tamSegmento-1)/VP_tamSegmento;
+
+   VP_segmentos.resize(qtdeSeg);
+   VP_ordemSeg.resize(qtdeSeg);
+   for (int s=0; s<qtdeSeg; s++)
+   {
+      TSegmento &seg = VP_segmentos[s];
+      int ini = s*VP_tamSegmento;
+      int fim = std::min(ini+VP_tamSegmento, VP_qtde);
+
+      seg.cidades.assign(rota+ini, rota+fim);
+      seg.invertido = false;
+      seg.ordem = s;
+      VP_ordemSeg[s] = s;
+      for (int i=ini; i<fim; i++)
+      {
+         VP_segCidade[rota[i]] = s;
+         VP_posCidade[rota[i]] = i-ini;
+      }
+   }
+}
+
+void TRotaDoisNiveis::get_rota (int *rota)
+{
+   int c = 0;
+   for (int i=0; i<VP_qtde; i++, c = prox(c)) rota[i] = c;
+}
+
+int TRotaDoisNiveis::prox (int cidade) const
+{
+   const TSegmento &s = VP_segmentos[VP_segCidade[cidade]];
+   int i = get_indice(cidade);
+
+   if (i+1<(int)s.cidades.size()) return get_cidade(VP_segCidade[cidade], i+1);
+   return get_cidade(VP_ordemSeg[(s.ordem+1)%VP_ordemSeg.size()], 0);
+}
+
+int TRotaDoisNiveis::ant (int cidade) const
+{
+   const TSegmento &s = VP_segmentos[VP_segCidade[cidade]];
+   int i = get_indice(cidade);
+
+   if (i>0) return get_cidade(VP_segCidade[cidade], i-1);
+   int segAnt = VP_ordemSeg[(s.ordem+VP_ordemSeg.size()-1)%VP_ordemSeg.size()];
+   return get_cidade(segAnt, VP_segmentos[segAnt].cidades.size()-1);
+}
+
+bool TRotaDoisNiveis::entre (int a, int b, int c) const
+{
+   //Compara pela posição do segmento e, no mesmo segmento, pela posição dentro dele
+   long pa = ((long)VP_segmentos[VP_segCidade[a]].ordem<<32) + get_indice(a);
+   long pb = ((long)VP_segmentos[VP_segCidade[b]].ordem<<32) + get_indice(b);
+   long pc = ((long)VP_segmentos[VP_segCidade[c]].ordem<<32) + get_indice(c);
+
+   if (pa<=pc) return (pa<=pb)&&(pb<=pc);
+   return (pb>=pa)||(pb<=pc);
+}
+
+void TRotaDoisNiveis::divide (int cidade)
+{
+   int s = VP_segCidade[cidade];
+   int i = get_indice(cidade);
+   if (i==0) return;
+
+   //O novo segmento fica com as cidades de cidade até o fim do segmento,
+   //na mesma orientação, logo depois dele na rota
+   int novo = VP_segmentos.size();
+   VP_segmentos.push_back(TSegmento());
+   TSegmento &seg = VP_segmentos[s];
+   TSegmento &segNovo = VP_segmentos[novo];
+   int p = VP_posCidade[cidade];
+
+   segNovo.invertido = seg.invertido;
+   if (!seg.invertido)
+   {
+      segNovo.cidades.assign(seg.cidades.begin()+p, seg.cidades.end());
+      seg.cidades.resize(p);
+   }
+   else
+   {
+      segNovo.cidades.assign(seg.cidades.begin(), seg.cidades.begin()+p+1);
+      seg.cidades.erase(seg.cidades.begin(), seg.cidades.begin()+p+1);
+      for (unsigned k=0; k<seg.cidades.size(); k++) VP_posCidade[seg.cidades[k]] = k;
+   }
+
+   for (unsigned k=0; k<segNovo.cidades.size(); k++)
+   {
+      VP_segCidade[segNovo.cidades[k]] = novo;
+      VP_posCidade[segNovo.cidades[k]] = k;
+   }
+
+   VP_ordemSeg.insert(VP_ordemSeg.begin()+seg.ordem+1, novo);
+   for (unsigned o=seg.ordem+1; o<VP_ordemSeg.size(); o++) VP_segmentos[VP_ordemSeg[o]].ordem = o;
+}
+
+void TRotaDoisNiveis::inverteSegmentos (int ini, int fim)
+{
+   int qtdeSeg = VP_ordemSeg.size();
+   int qtde = (fim-ini+qtdeSeg)%qtdeSeg+1;
+
+   for (int k=0; k<qtde/2; k++)
+      std::swap(VP_ordemSeg[(ini+k)%qtdeSeg], VP_ordemSeg[(fim-k+qtdeSeg)%qtdeSeg]);
+
+   for (int k=0; k<qtde; k++)
+   {
+      int o = (ini+k)%qtdeSeg;
+      TSegmento &seg = VP_segmentos[VP_ordemSeg[o]];
+      seg.invertido = !seg.invertido;
+      seg.ordem = o;
+   }
+}
+
+void TRotaDoisNiveis::inverte (int a, int b)
+{
+   if (a==b) return;
+
+   int sa = VP_segCidade[a];
+   int sb = VP_segCidade[b];
+
+   //Caminho dentro de um segmento: inverte as cidades no próprio vetor
+   if ((sa==sb)&&(get_indice(a)<=get_indice(b)))
+   {
+      TSegmento &seg = VP_segmentos[sa];
+      int p1 = std::min(VP_posCidade[a], VP_posCidade[b]);
+      int p2 = std::max(VP_posCidade[a], VP_posCidade[b]);
+
+      std::reverse(seg.cidades.begin()+p1, seg.cidades.begin()+p2+1);
+      for (int k=p1; k<=p2; k++) VP_posCidade[seg.cidades[k]] = k;
+      return;
+   }
+
+   //a passa a ser o primeiro e b o último dos seus segmentos
+   divide(a);
+   divide(prox(b));
+
+   int qtdeSeg = VP_ordemSeg.size();
+   int ini = VP_segmentos[VP_segCidade[a]].ordem;
+   int fim = VP_segmentos[VP_segCidade[b]].ordem;
+   int qtde = (fim-ini+qtdeSeg)%qtdeSeg+1;
+
+   //Inverter o complemento dá a mesma rota percorrida no sentido contrário
+   if ((qtde<qtdeSeg)&&(2*qtde>qtdeSeg)) inverteSegmentos((fim+1)%qtdeSeg, (ini-1+qtdeSeg)%qtdeSeg);
+   else                                  inverteSegmentos(ini, fim);
+
+   //Cada divisão cria um segmento. Com o dobro da quantidade inicial,
+   //a rota é remontada com segmentos do tamanho original
+   if (qtdeSeg > 2*((VP_qtde+VP_tamSegmento-1)/VP_tamSegmento))
+   {
+      std::vector<int> rota(VP_qtde);
+      get_rota(&rota[0]);
+      monta(&rota[0]);
+   }
+}
@@ -0,0 +1,85 @@
+/*
+*  rotadoisniveis.hpp
+*
+*  Módulo responsável pela rota em lista de dois níveis, para a busca local nas instâncias grandes
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _ROTADOISNIVEIS_H
+#define	_ROTADOISNIVEIS_H
+
+#include <vector>
+
+/*******************************************************
+classe de TRotaDoisNiveis. Rota em lista de dois níveis
+(Fredman et al., 1995): as cidades ficam divididas em
+segmentos de aproximadamente raiz(n) cidades, e cada
+segmento tem um bit de inversão. Inverter um trecho da rota
+custa O(raiz(n)): as pontas são separadas em segmentos
+próprios, a ordem dos segmentos do trecho é invertida e o
+bit de cada um é trocado, sem mexer nas cidades. prox, ant
+e entre são O(1).
+
+No vetor de indivíduos uma inversão custa O(n), o que passa
+a dominar a busca local nas instâncias com dezenas de
+milhares de cidades. A rota é carregada do indivíduo antes
+da busca e devolvida no final.
+
+Sem orientação fixa: para encurtar, uma inversão pode
+inverter o complemento do trecho, e a rota inteira passa a
+ser percorrida no sentido contrário. Serve para a matriz
+simétrica, onde o sentido não altera o custo.
+********************************************************/
+class TRotaDoisNiveis
+{
+   private:
+      struct TSegmento
+      {
+         std::vector<int> cidades;
+         bool invertido;
+         int ordem;                        //Posição do segmento na rota
+      };
+
+      int VP_qtde;
+      int VP_tamSegmento;                  //Tamanho dos segmentos na montagem
+
+      std::vector<TSegmento> VP_segmentos;
+      std::vector<int> VP_ordemSeg;        //Posição na rota -> segmento
+      std::vector<int> VP_segCidade;       //Cidade -> segmento
+      std::vector<int> VP_posCidade;       //Cidade -> posição no vetor do segmento
+
+      //Posição da cidade no sentido da rota dentro do segmento, e o inverso
+      int get_indice (int cidade) const;
+      int get_cidade (int segmento, int indice) const;
+
+      void monta (const int *rota);
+      //Separa o segmento para que a cidade seja a primeira do seu segmento
+      void divide (int cidade);
+      //Inverte a ordem dos segmentos das posições ini a fim (circular)
+      void inverteSegmentos (int ini, int fim);
+
+   public:
+      TRotaDoisNiveis ();
+
+      //rota com as cidades 0..qtde-1
+      void carrega (const int *rota, int qtde);
+      //Rota começando pela cidade 0
+      void get_rota (int *rota);
+
+      int get_qtde () const;
+
+      int prox (int cidade) const;
+      int ant (int cidade) const;
+      //Verdadeiro quando b está no caminho de a até c, no sentido da rota
+      bool entre (int a, int b, int c) const;
+
+      //Inverte o caminho de a até b, no sentido da rota
+      void inverte (int a, int b);
+};
+
+#endif	/* _ROTADOISNIVEIS_H */
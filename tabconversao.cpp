@@ -14,7 +14,7 @@
 #include "tabconversao.hpp"
 #include <iostream>
 
-TTabConversao::TTabConversao(TIndividuo *melhor, TIndividuo *select)
+TTabConversao::TTabConversao(TIndividuo *melhor, TIndividuo *select, TTabConversao *anterior)
 {
    TGene *g;
    TGene *tmp;
@@ -22,6 +22,9 @@ TTabConversao::TTabConversao(TIndividuo *melhor, TIndividuo *select)
 
    bool primeiro = true;
 
+   VP_mapa = melhor->getMapa();
+   VP_mapaReduzido = NULL;
+
    for(int i=0; i<melhor->get_qtdeGenes();i++)
    {
       g = melhor->get_por_indice(i);
@@ -35,7 +38,7 @@ TTabConversao::TTabConversao(TIndividuo *melhor, TIndividuo *select)
          primeiro = false;
       }
 
-      if ((g->prox->id != tmp->prox->id)||(g->prox->id==0))
+      if ((melhor->prox(g)->id != select->prox(tmp)->id)||(melhor->prox(g)->id==0))
       {
          item.ul = g->id;
          item.ulOrig = g->ori;
@@ -44,11 +47,21 @@ TTabConversao::TTabConversao(TIndividuo *melhor, TIndividuo *select)
          primeiro = true;
       }
    }
+
+   VP_chave.resize(2*VP_tabConv.size());
+   for (unsigned i=0; i<VP_tabConv.size(); i++)
+   {
+      int entrada = VP_tabConv[i].prDest;
+      int saida   = VP_tabConv[i].ulOrig;
+      VP_chave[2*i]   = anterior?anterior->VP_chave[2*entrada]:entrada;
+      VP_chave[2*i+1] = anterior?anterior->VP_chave[2*saida+1]:saida;
+   }
 }
 
 TTabConversao::~TTabConversao()
 {
    VP_tabConv.clear();
+   delete VP_mapaReduzido;
 }
 
 int TTabConversao::get_quantidade()
@@ -61,6 +74,38 @@ vector<TTipoConversao> TTabConversao::get_vetConv()
    return VP_tabConv;
 }
 
+const vector<int> &TTabConversao::get_chave()
+{
+   return VP_chave;
+}
+
+vector<TTipoConversao> TTabConversao::get_vetConvReduzido()
+{
+   vector<TTipoConversao> tabConv(VP_tabConv.size());
+   for (unsigned i=0; i<tabConv.size(); i++)
+   {
+      tabConv[i].pr = tabConv[i].prOrig = tabConv[i].prDest = i;
+      tabConv[i].ul = tabConv[i].ulOrig = tabConv[i].ulDest = i;
+   }
+   return tabConv;
+}
+
+TMapaGenes *TTabConversao::get_mapaReduzido()
+{
+   if (VP_mapaReduzido) return VP_mapaReduzido;
+
+   int qtde = VP_tabConv.size();
+   VP_mapaReduzido = new TMapaGenes(qtde);
+   for (int i=0; i<qtde; i++)
+      for (int j=0; j<qtde; j++)
+         if (i!=j) VP_mapaReduzido->set_distancia(i, j, VP_mapa->get_distancia(VP_tabConv[i].ulOrig, VP_tabConv[j].prDest));
+
+   //Mesmo armazenamento automático do mapa principal: inteiros pequenos
+   //em 16 bits e, se for simétrica, apenas o triângulo inferior
+   VP_mapaReduzido->compacta();
+   return VP_mapaReduzido;
+}
+
 string TTabConversao::toString()
 {
    string resultado = "";
@@ -102,7 +147,7 @@ void TTabConversao::converte(TIndividuo *individuo, TIndividuo *indReduzido)
 	  {
          gTemp = gI;
 		 aux[indG] = gI->id;
-		 gI = gI->prox;
+		 gI = individuo->prox(gI);
 		 indG++;
 	  }while(gTemp->id!=c.ul);	  
    }
@@ -19,16 +19,45 @@
 #include "populacao.hpp"
 #include "tsp.hpp"
 
+/*******************************************************
+Tabela de conversão entre um indivíduo e o indivíduo
+reduzido, onde cada sequência em comum com o melhor vira
+um gene (fragmento).
+
+O AG recursivo roda sobre um mapa reduzido, com a matriz
+k x k do custo de ir de um fragmento ao outro (da saída
+ulOrig de i à entrada prDest de j). Com ele, os genes do
+nível seguinte são as próprias cidades do mapa reduzido
+e cada distância é lida de uma tabela pequena e contígua,
+sem passar pelas cidades do mapa anterior. O mapa só é
+montado quando o AG recursivo é executado, e é liberado
+junto com a tabela.
+
+Como os genes de cada nível são números locais, a tabela
+guarda também a cidade da instância por onde se entra e
+por onde se sai de cada fragmento (a chave), traduzidas
+pela tabela do nível anterior. O custo entre fragmentos
+depende só delas, o que identifica o problema reduzido em
+qualquer profundidade (ver TCacheReduzidos).
+********************************************************/
 class TTabConversao
 {
    private:
       vector<TTipoConversao> VP_tabConv;
+      TMapaGenes *VP_mapa;          //Mapa dos indivíduos convertidos
+      TMapaGenes *VP_mapaReduzido;  //NULL até ser pedido
+      vector<int> VP_chave;         //Entrada e saída de cada fragmento na instância
 
    public:
-      TTabConversao(TIndividuo *melhor, TIndividuo *select);
+      //anterior é a tabela que gerou o mapa dos indivíduos, NULL no mapa da instância
+      TTabConversao(TIndividuo *melhor, TIndividuo *select, TTabConversao *anterior = NULL);
       ~TTabConversao();
 	  int get_quantidade();
 	  vector<TTipoConversao> get_vetConv();
+	  //Tabela do nível seguinte: o fragmento i é a cidade i do mapa reduzido
+	  vector<TTipoConversao> get_vetConvReduzido();
+	  TMapaGenes *get_mapaReduzido();
+	  const vector<int> &get_chave();
 	  void converte(TIndividuo *individuo, TIndividuo *indReduzido);
 	  string toString();
 };
@@ -20,18 +20,15 @@ const double infinito = 1000000.00;
 ********************************************************/
 /*************************************************************
     Estrutura referente a um gene, representando 1 cidade
-Contém 2 ponteriros para o anterior e posterior. Também
-duas informações que representam a cidade referente quando
-está é destino e quando é origem
+Contém duas informações que representam a cidade referente
+quando está é destino e quando é origem. A posição do gene e
+os vizinhos ficam no indivíduo (ver TIndividuo)
 *************************************************************/
 struct TGene
 {
    int id;
    int ori;   //O gene sendo a origem
    int dest;  //O gene sendo o detstino
-   int i;     //A posição de um gene
-   struct TGene *prox;
-   struct TGene *ant;
 };
 
 struct TTipoConversao
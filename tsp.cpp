@@ -11,168 +11,1472 @@
 */
 
 #include "tsp.hpp"
+#include "leitor.hpp"
+#include "kdtree.hpp"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //Metodos Privados
-int TMapaGenes::getNumGeneDoArquivo(xmlDocPtr doc, xmlNode * a_node)
+
+//Lê as arestas <edge cost="...">destino</edge> de um <vertex>
+void TMapaGenes::preencheMapaDist (int geneOri, TLeitor &leitor, const char *fimVertice)
 {
-    xmlNode *cur_node = NULL;
-    xmlChar *key;
-    int val;
+    const char *aresta;
+    const char *fimTag;
+    const char *atributo;
+    double custo;
+    long geneDest;
 
-    for (cur_node = a_node; cur_node; cur_node = cur_node->next)
+    while ((aresta = leitor.procura("<edge", fimVertice)) != NULL)
     {
-       if (cur_node->type == XML_ELEMENT_NODE)
+       fimTag = (const char *) memchr(aresta, '>', fimVertice-aresta);
+       if (fimTag == NULL) break;
+
+       //Sem o atributo cost, a distância é 0
+       custo = 0;
+       leitor.set_posicao(aresta + 5);
+       atributo = leitor.procura("cost", fimTag);
+       if (atributo != NULL)
        {
-          if (!xmlStrcmp(cur_node->name, (xmlChar *)"description"))
-          {
-             key = xmlNodeListGetString(doc, cur_node->xmlChildrenNode, 1);
-             val = atoi((char *)key);
-             xmlFree(key);
-             return val;
-          }
+          leitor.set_posicao(atributo + 4);
+          leitor.pulaCaractere('=');
+          if (!leitor.pulaCaractere('"')) leitor.pulaCaractere('\'');
+          if (!leitor.leNumero(custo)) custo = 0;
+       }
+
+       leitor.set_posicao(fimTag + 1);
+       if (leitor.leInteiro(geneDest))
+       {
+          //Mantém o arredondamento para float da leitura original
+          set_distancia(geneOri, (int) geneDest, (float) custo);
        }
     }
-    return 0;
  }
 
-void TMapaGenes::preencheMapaDist (int geneOri, xmlDocPtr doc, xmlNode * a_node)
+TMapaGenes::TMapaGenes ()
 {
-    xmlNode *cur_node = NULL;
-    xmlChar *uri;
-    xmlChar *key;
-    char dist[25];
-    int geneDest;
-    float df;
+      VP_qtdeGenes = -1;
+      VP_stride = 0;
+      VP_qtdeElementos = 0;
+      VP_mapaDist  = NULL;
+      VP_mapaDistF = NULL;
+      VP_mapaDistI = NULL;
+      VP_mapaDistU = NULL;
+      VP_armazenamento = armazenamentoDouble;
+      VP_armazenamentoPedido = armazenamentoAuto;
+      VP_compactada = false;
+      VP_simetrico = false;
+      VP_inteira = false;
+      VP_escala = 1.0;
+      VP_tipoDistancia = distanciaExplicita;
+      VP_x = NULL;
+      VP_y = NULL;
+      VP_usaCache = false;
+      VP_areaMapeada = NULL;
+      VP_tamMapeado = 0;
+      VP_qtdeCandidatos = 0;
+      VP_candidatos = NULL;
+      VP_arvore = NULL;
+      VP_renumeracaoPedida = renumeracaoNenhuma;
+      VP_idOriginal = NULL;
+}
 
-    for (cur_node = a_node; cur_node; cur_node = cur_node->next)
-    {
-       if (cur_node->type == XML_ELEMENT_NODE)
+TMapaGenes::TMapaGenes (int numGenes) : TMapaGenes()
+{
+   inicializa (numGenes);
+}
+
+int TMapaGenes::get_qtdeGenes () { return VP_qtdeGenes; };
+
+int TMapaGenes::get_armazenamento () { return VP_armazenamento; }
+bool TMapaGenes::is_inteira ()       { return VP_inteira; }
+bool TMapaGenes::is_simetrico ()     { return VP_simetrico; }
+
+void TMapaGenes::set_armazenamento (int armazenamento) { VP_armazenamentoPedido = armazenamento; }
+void TMapaGenes::set_usaCache (bool usaCache)          { VP_usaCache = usaCache; }
+void TMapaGenes::set_renumeracao (int renumeracao)     { VP_renumeracaoPedida = renumeracao; }
+bool TMapaGenes::is_mapeado ()                         { return VP_areaMapeada!=NULL; }
+bool TMapaGenes::is_renumerado ()                      { return VP_idOriginal!=NULL; }
+
+int TMapaGenes::get_tipoDistancia () { return VP_tipoDistancia; }
+bool TMapaGenes::is_coordenadas ()   { return VP_tipoDistancia!=distanciaExplicita; }
+
+std::string TMapaGenes::get_nomeTipoDistancia ()
+{
+   switch (VP_tipoDistancia)
+   {
+      case distanciaEUC2D:  return "EUC_2D";
+      case distanciaCEIL2D: return "CEIL_2D";
+      case distanciaATT:    return "ATT";
+      case distanciaGEO:    return "GEO";
+      default:              return "EXPLICIT";
+   }
+}
+
+std::string TMapaGenes::get_nomeArmazenamento ()
+{
+   if (is_coordenadas()) return "coordenadas " + get_nomeTipoDistancia();
+
+   switch (VP_armazenamento)
+   {
+      case armazenamentoFloat:  return "float";
+      case armazenamentoInt32:  return "int32";
+      case armazenamentoUInt16: return (VP_escala==1.0)?"uint16":"uint16 (quantizado)";
+      default:                  return "double";
+   }
+}
+
+//Tamanho em bytes de cada bloco alocado: a tabela, ou cada
+//um dos vetores de coordenadas
+size_t TMapaGenes::get_tamanhoBloco ()
+{
+   size_t tam;
+   switch (is_coordenadas()?armazenamentoDouble:VP_armazenamento)
+   {
+      case armazenamentoFloat:  tam = sizeof(float);    break;
+      case armazenamentoInt32:  tam = sizeof(int32_t);  break;
+      case armazenamentoUInt16: tam = sizeof(uint16_t); break;
+      default:                  tam = sizeof(double);   break;
+   }
+   return tam*VP_qtdeElementos;
+}
+
+size_t TMapaGenes::get_tamanhoTabela ()
+{
+   if (is_coordenadas()) return 2*sizeof(double)*VP_qtdeGenes;
+   return get_tamanhoBloco();
+}
+
+//O XML começa por '<'. Qualquer outro conteúdo é lido como TSPLIB
+static bool isArquivoXML(char *nomeArquivo)
+{
+       FILE *arq = fopen(nomeArquivo, "r");
+       int c = EOF;
+
+       if (arq == NULL) return true; //O carregador XML informa o erro
+       do { c = fgetc(arq); } while ((c==' ')||(c=='\t')||(c=='\r')||(c=='\n'));
+       fclose(arq);
+       return c=='<';
+}
+
+void TMapaGenes::carregaDoArquivo(char *nomeArquivo)
+{
+       std::string nomeCache = std::string(nomeArquivo) + ".cache";
+
+       if (VP_usaCache && carregaCache(nomeCache, nomeArquivo)) return;
+
+       if (isArquivoXML(nomeArquivo)) carregaXML(nomeArquivo);
+       else                           carregaTSPLIB(nomeArquivo);
+
+       if ((VP_renumeracaoPedida!=renumeracaoNenhuma) && (VP_qtdeGenes>1)) renumera();
+       if (VP_usaCache && (VP_qtdeGenes>0)) gravaCache(nomeCache, nomeArquivo);
+}
+
+/*******************************************************
+Cabeçalho do cache binário. Ocupa a primeira página do
+arquivo, para que as tabelas mapeadas comecem alinhadas.
+Em seguida vêm os blocos exatamente como ficam na memória:
+a tabela compactada, ou os vetores x[] e y[], e, quando as
+cidades foram renumeradas, o número original de cada uma
+(a partir de um múltiplo de 8 bytes).
+Qualquer mudança no layout deve incrementar versaoCache.
+********************************************************/
+static const char assinaturaCache[8] = { 'T', 'S', 'P', 'M', 'A', 'P', 'A', '\0' };
+static const uint32_t versaoCache = 2;
+static const size_t tamCabecalhoCache = 4096;
+
+static inline uint64_t alinha8(uint64_t tam) { return (tam + 7) & ~((uint64_t)7); }
+
+struct TCabecalhoCache
+{
+   char assinatura[8];
+   uint32_t versao;
+   uint32_t tamCabecalho;
+   int32_t qtdeGenes;
+   int32_t armazenamentoPedido;
+   int32_t armazenamento;
+   int32_t tipoDistancia;
+   int32_t simetrico;
+   int32_t inteira;
+   int32_t renumeracao;
+   int32_t reservado;
+   double escala;
+   uint64_t stride;
+   uint64_t qtdeElementos;
+   uint64_t tamBloco;
+   uint64_t qtdeBlocos;
+   uint64_t tamIds;          //Bytes dos números originais, 0 sem renumeração
+   uint64_t tamanhoOrigem;   //Identificação do arquivo de instância
+   int64_t mtimeOrigem;      //que gerou o cache
+};
+
+bool TMapaGenes::carregaCache(const std::string &nomeCache, const char *nomeArquivo)
+{
+       struct stat origem, cache;
+
+       if (stat(nomeArquivo, &origem)!=0) return false;
+
+       int fd = open(nomeCache.c_str(), O_RDONLY);
+       if (fd<0) return false;
+
+       if ((fstat(fd, &cache)!=0)||((size_t)cache.st_size<tamCabecalhoCache))
        {
-          uri = xmlGetProp(cur_node, (const xmlChar *)"cost");
-          sprintf(dist, "0%s", uri);
-          df = atof (dist);
+          close(fd);
+          return false;
+       }
 
-          key = xmlNodeListGetString(doc, cur_node->xmlChildrenNode, 1);
-          geneDest = atoi((char *)key);
+       void *area = mmap(NULL, cache.st_size, PROT_READ, MAP_SHARED, fd, 0);
+       close(fd);
+       if (area==MAP_FAILED) return false;
 
-          set_distancia(geneOri, geneDest, df);
+       const TCabecalhoCache *cab = (const TCabecalhoCache *) area;
+       bool valido = (memcmp(cab->assinatura, assinaturaCache, sizeof(assinaturaCache))==0) &&
+                     (cab->versao==versaoCache) &&
+                     (cab->tamCabecalho==tamCabecalhoCache) &&
+                     (cab->tamanhoOrigem==(uint64_t)origem.st_size) &&
+                     (cab->mtimeOrigem==(int64_t)origem.st_mtime) &&
+                     (cab->armazenamentoPedido==VP_armazenamentoPedido) &&
+                     (cab->renumeracao==VP_renumeracaoPedida) &&
+                     (cab->qtdeGenes>0) &&
+                     ((cab->tamIds==0)||(cab->tamIds==sizeof(int32_t)*cab->qtdeGenes)) &&
+                     ((uint64_t)cache.st_size==tamCabecalhoCache + alinha8(cab->tamBloco*cab->qtdeBlocos) + cab->tamIds);
+       if (!valido)
+       {
+          munmap(area, cache.st_size);
+          return false;
+       }
 
-          xmlFree(key);
-    xmlFree(uri);
+       liberaTabela();
+
+       VP_qtdeGenes = cab->qtdeGenes;
+       VP_armazenamento = cab->armazenamento;
+       VP_tipoDistancia = cab->tipoDistancia;
+       VP_simetrico = cab->simetrico;
+       VP_inteira = cab->inteira;
+       VP_escala = cab->escala;
+       VP_stride = cab->stride;
+       VP_qtdeElementos = cab->qtdeElementos;
+       VP_compactada = true;
+
+       char *dados = (char *) area + tamCabecalhoCache;
+       if (is_coordenadas())
+       {
+          VP_x = (double *) dados;
+          VP_y = (double *) (dados + cab->tamBloco);
+       }
+       else
+       {
+          switch (VP_armazenamento)
+          {
+             case armazenamentoFloat:  VP_mapaDistF = (float *) dados;    break;
+             case armazenamentoInt32:  VP_mapaDistI = (int32_t *) dados;  break;
+             case armazenamentoUInt16: VP_mapaDistU = (uint16_t *) dados; break;
+             default:                  VP_mapaDist  = (double *) dados;   break;
+          }
        }
 
-    }
- }
+       if (cab->tamIds) VP_idOriginal = (int32_t *) (dados + alinha8(cab->tamBloco*cab->qtdeBlocos));
+
+       VP_areaMapeada = area;
+       VP_tamMapeado = cache.st_size;
+       return true;
+}
 
-void TMapaGenes::preencheMapa(xmlDocPtr doc, xmlNode * a_node)
+void TMapaGenes::gravaCache(const std::string &nomeCache, const char *nomeArquivo)
 {
-    xmlNode *cur_node = NULL;
-    int gene=0;
+       struct stat origem;
+       char cabecalho[tamCabecalhoCache];
+       TCabecalhoCache cab;
+       const void *blocos[2] = { NULL, NULL };
 
-    for (cur_node = a_node; cur_node; cur_node = cur_node->next)
-    {
-       if (cur_node->type == XML_ELEMENT_NODE)
+       if (stat(nomeArquivo, &origem)!=0) return;
+
+       memset(&cab, 0, sizeof(cab));
+       memcpy(cab.assinatura, assinaturaCache, sizeof(assinaturaCache));
+       cab.versao = versaoCache;
+       cab.tamCabecalho = tamCabecalhoCache;
+       cab.qtdeGenes = VP_qtdeGenes;
+       cab.armazenamentoPedido = VP_armazenamentoPedido;
+       cab.armazenamento = VP_armazenamento;
+       cab.tipoDistancia = VP_tipoDistancia;
+       cab.simetrico = VP_simetrico;
+       cab.inteira = VP_inteira;
+       cab.renumeracao = VP_renumeracaoPedida;
+       cab.escala = VP_escala;
+       cab.stride = VP_stride;
+       cab.qtdeElementos = VP_qtdeElementos;
+       cab.tamBloco = get_tamanhoBloco();
+       cab.qtdeBlocos = is_coordenadas()?2:1;
+       cab.tamIds = VP_idOriginal?sizeof(int32_t)*VP_qtdeGenes:0;
+       cab.tamanhoOrigem = origem.st_size;
+       cab.mtimeOrigem = origem.st_mtime;
+
+       if (is_coordenadas())
        {
-          if (!xmlStrcmp(cur_node->name, (xmlChar *)"vertex"))
+          blocos[0] = VP_x;
+          blocos[1] = VP_y;
+       }
+       else
+       {
+          switch (VP_armazenamento)
           {
-             preencheMapaDist(gene++, doc, cur_node->children);
+             case armazenamentoFloat:  blocos[0] = VP_mapaDistF; break;
+             case armazenamentoInt32:  blocos[0] = VP_mapaDistI; break;
+             case armazenamentoUInt16: blocos[0] = VP_mapaDistU; break;
+             default:                  blocos[0] = VP_mapaDist;  break;
           }
        }
-       preencheMapa(doc, cur_node->children);
-    }
+
+       //Grava em um arquivo temporário e renomeia, para que outro processo
+       //nunca mapeie um cache incompleto. Sem permissão de escrita no
+       //diretório da instância, o cache simplesmente não é criado
+       std::string temporario = nomeCache + "." + std::to_string(getpid());
+       FILE *arq = fopen(temporario.c_str(), "wb");
+       if (arq == NULL) return;
+
+       memset(cabecalho, 0, sizeof(cabecalho));
+       memcpy(cabecalho, &cab, sizeof(cab));
+
+       bool ok = fwrite(cabecalho, 1, tamCabecalhoCache, arq)==tamCabecalhoCache;
+       for (uint64_t b=0; ok&&(b<cab.qtdeBlocos); b++)
+          ok = fwrite(blocos[b], 1, cab.tamBloco, arq)==cab.tamBloco;
+       if (ok&&cab.tamIds)
+       {
+          const char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+          size_t ajuste = alinha8(cab.tamBloco*cab.qtdeBlocos) - cab.tamBloco*cab.qtdeBlocos;
+          ok = (fwrite(zeros, 1, ajuste, arq)==ajuste) &&
+               (fwrite(VP_idOriginal, 1, cab.tamIds, arq)==cab.tamIds);
+       }
+       ok = (fclose(arq)==0)&&ok;
+
+       if (ok) ok = rename(temporario.c_str(), nomeCache.c_str())==0;
+       if (!ok)
+       {
+          remove(temporario.c_str());
+          printf("Aviso: não foi possível gravar o cache %s\n", nomeCache.c_str());
+       }
 }
 
-TMapaGenes::TMapaGenes ()
+template <typename T>
+static T *copiaBloco(const T *origem, size_t tam)
 {
-      VP_qtdeGenes = -1;
+       void *bloco;
+
+       if (posix_memalign(&bloco, 64, tam) != 0)
+       {
+          printf("Erro ao alocar a tabela de distâncias\n");
+          exit(1);
+       }
+       memcpy(bloco, origem, tam);
+       return (T *) bloco;
 }
 
-TMapaGenes::TMapaGenes (int numGenes)
+//O cache é mapeado apenas para leitura. Antes de qualquer alteração
+//a tabela passa para uma cópia privada do processo
+void TMapaGenes::copiaMapeada()
 {
-   inicializa (numGenes);
+       size_t tam = get_tamanhoBloco();
+
+       if (VP_x) VP_x = copiaBloco(VP_x, tam);
+       if (VP_y) VP_y = copiaBloco(VP_y, tam);
+       if (VP_mapaDist)  VP_mapaDist  = copiaBloco(VP_mapaDist, tam);
+       if (VP_mapaDistF) VP_mapaDistF = copiaBloco(VP_mapaDistF, tam);
+       if (VP_mapaDistI) VP_mapaDistI = copiaBloco(VP_mapaDistI, tam);
+       if (VP_mapaDistU) VP_mapaDistU = copiaBloco(VP_mapaDistU, tam);
+       if (VP_idOriginal) VP_idOriginal = copiaBloco(VP_idOriginal, sizeof(int32_t)*VP_qtdeGenes);
+
+       munmap(VP_areaMapeada, VP_tamMapeado);
+       VP_areaMapeada = NULL;
+       VP_tamMapeado = 0;
 }
 
-int TMapaGenes::get_qtdeGenes () { return VP_qtdeGenes; };
+static inline bool isEspaco(char c) { return (c==' ')||(c=='\t')||(c=='\r')||(c=='\n'); }
 
-void TMapaGenes::carregaDoArquivo(char *nomeArquivo)
+//Quantidade de trechos para dividir a leitura entre as threads.
+//Trechos menores que 1MB não compensam o custo de abrir as threads
+static int qtdeTrechos(size_t tamanho)
 {
-       xmlDoc *doc = NULL;
-       xmlNode *root_element = NULL;
+       int trechos = 1;
+#ifdef _OPENMP
+       trechos = omp_get_max_threads();
+#endif
+       if ((size_t)trechos > tamanho/(1<<20)) trechos = (int)(tamanho/(1<<20));
+       return (trechos<1)?1:trechos;
+}
 
-       // Lendo o arquivo
-       doc = xmlReadFile(nomeArquivo, NULL, 0);
+//Todas as ocorrências de tag entre inicio e fim, procuradas
+//em paralelo e devolvidas na ordem do arquivo
+static void localizaTags(TLeitor &leitor, const char *inicio, const char *fim, const char *tag, std::vector<const char *> &posicoes)
+{
+       int trechos = qtdeTrechos(fim-inicio);
+       size_t tamTag = strlen(tag);
+       std::vector< std::vector<const char *> > parciais(trechos);
 
-       if (doc == NULL)
+       #pragma omp parallel for schedule(static, 1)
+       for (int t=0; t<trechos; t++)
+       {
+          TLeitor trecho;
+          const char *a = inicio + (fim-inicio)*t/trechos;
+          const char *b = inicio + (fim-inicio)*(t+1)/trechos;
+          const char *p;
+
+          //Uma tag que começa no trecho pode terminar no seguinte
+          trecho.abreTrecho(leitor, a, ((size_t)(fim-b)>=tamTag)?b+tamTag:fim);
+          while (((p = trecho.procura(tag)) != NULL)&&(p<b))
+          {
+             parciais[t].push_back(p);
+             trecho.set_posicao(p + tamTag);
+          }
+       }
+
+       posicoes.clear();
+       for (int t=0; t<trechos; t++)
+          posicoes.insert(posicoes.end(), parciais[t].begin(), parciais[t].end());
+}
+
+void TMapaGenes::carregaXML(char *nomeArquivo)
+{
+       TLeitor leitor;
+       const char *descricao;
+       std::vector<const char *> vertices;
+
+       // Lendo o arquivo
+       if (!leitor.abre(nomeArquivo))
        {
           printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
           return;
        }
 
-       // Obtendo o elemento root
-       root_element = xmlDocGetRootElement(doc);
+       //Obtendo o número de genes pela descrição ("96 - Africa...").
+       //Quando a descrição não começa por um número (kro124p, por
+       //exemplo), vale a quantidade de vértices do arquivo
+       VP_qtdeGenes = 0;
+       if ((descricao = leitor.procura("<description")) != NULL)
+       {
+          const char *fimTag;
+          long num;
 
-       //Obtendo o número de genes no arquivo
-       VP_qtdeGenes = getNumGeneDoArquivo(doc, root_element->children);
+          leitor.set_posicao(descricao);
+          fimTag = leitor.procura(">");
+          leitor.set_posicao(fimTag?fimTag+1:descricao);
+          if (leitor.leInteiro(num)) VP_qtdeGenes = (int) num;
+          leitor.set_posicao(leitor.get_inicio());
+       }
+       localizaTags(leitor, leitor.get_posicao(), leitor.get_fim(), "<vertex", vertices);
+       if (VP_qtdeGenes <= 0) VP_qtdeGenes = (int) vertices.size();
+       if (VP_qtdeGenes <= 0)
+       {
+          printf("Erro ao carregar o arquivo %s: nenhum <vertex> encontrado\n", nomeArquivo);
+          VP_qtdeGenes = -1;
+          return;
+       }
 
        //Alocando a tabela
        inicializa (VP_qtdeGenes);
 
-       //preenchendo a tabela com os valores da distáncia
-       preencheMapa(doc, root_element->children);
+       //preenchendo a tabela com os valores da distáncia. Cada vértice
+       //preenche apenas a sua linha, então os vértices são lidos em paralelo
+       int qtde = ((size_t)VP_qtdeGenes<vertices.size())?VP_qtdeGenes:(int)vertices.size();
+
+       #pragma omp parallel for schedule(dynamic, 16)
+       for (int gene=0; gene<qtde; gene++)
+       {
+          TLeitor trecho;
+          const char *fimVertice = (gene+1<(int)vertices.size())?vertices[gene+1]:leitor.get_fim();
+
+          trecho.abreTrecho(leitor, vertices[gene] + 7, fimVertice);
+          preencheMapaDist(gene, trecho, fimVertice);
+       }
+
+       //Escolhendo o armazenamento definitivo da tabela
+       compacta();
+}
+
+/*******************************************************
+Percorre as posições (i, j) da EDGE_WEIGHT_SECTION na
+ordem de cada EDGE_WEIGHT_FORMAT. Os formatos *_COL são
+a transposta dos *_ROW, e como os triângulos só existem
+em instâncias simétricas, UPPER_COL é lido como LOWER_ROW,
+LOWER_COL como UPPER_ROW e assim por diante.
+********************************************************/
+class TFormatoPesos
+{
+   public:
+      static const int completa      = 0;
+      static const int superior      = 1;
+      static const int superiorDiag  = 2;
+      static const int inferior      = 3;
+      static const int inferiorDiag  = 4;
+      static const int invalido      = -1;
+
+      int tipo;
+      int n;
+      int i;
+      int j;
+
+      TFormatoPesos(const std::string &formato, int numGenes)
+      {
+         n = numGenes;
+         if      (formato=="FULL_MATRIX")                                     tipo = completa;
+         else if ((formato=="UPPER_ROW")||(formato=="LOWER_COL"))             tipo = superior;
+         else if ((formato=="UPPER_DIAG_ROW")||(formato=="LOWER_DIAG_COL"))   tipo = superiorDiag;
+         else if ((formato=="LOWER_ROW")||(formato=="UPPER_COL"))             tipo = inferior;
+         else if ((formato=="LOWER_DIAG_ROW")||(formato=="UPPER_DIAG_COL"))   tipo = inferiorDiag;
+         else                                                                 tipo = invalido;
+         inicio();
+      }
+
+      void inicio()
+      {
+         i = (tipo==inferior)?1:0;
+         j = (tipo==superior)?1:0;
+      }
+
+      long get_qtde()
+      {
+         switch (tipo)
+         {
+            case completa:                 return (long)n*n;
+            case superior: case inferior:  return (long)n*(n-1)/2;
+            default:                       return (long)n*(n+1)/2;
+         }
+      }
+
+      //Índice do primeiro valor da linha l e a coluna onde ele fica
+      long inicioLinha(long l)
+      {
+         switch (tipo)
+         {
+            case completa:     return l*n;
+            case superior:     return l*(n-1) - l*(l-1)/2;
+            case superiorDiag: return l*n - l*(l-1)/2;
+            case inferior:     return l*(l-1)/2;
+            default:           return l*(l+1)/2;
+         }
+      }
+
+      int primeiraColuna(int l)
+      {
+         if (tipo==superior)     return l+1;
+         if (tipo==superiorDiag) return l;
+         return 0;
+      }
+
+      //Posiciona (i, j) no k-ésimo valor da seção
+      void posiciona(long k)
+      {
+         int a = (tipo==inferior)?1:0;
+         int b = n-1;
+
+         while (a<b)
+         {
+            int m = (a+b+1)/2;
+            if (inicioLinha(m)<=k) a = m;
+            else                   b = m-1;
+         }
+         i = a;
+         j = primeiraColuna(i) + (int)(k - inicioLinha(i));
+      }
+
+      void avanca()
+      {
+         switch (tipo)
+         {
+            case completa:     if (++j==n) { i++; j = 0;   } break;
+            case superior:     if (++j==n) { i++; j = i+1; } break;
+            case superiorDiag: if (++j==n) { i++; j = i;   } break;
+            case inferior:     if (++j==i) { i++; j = 0;   } break;
+            default:           if (++j>i)  { i++; j = 0;   } break;
+         }
+      }
+};
+
+//Conta os valores entre inicio e fim. Uma palavra (EOF, DISPLAY_DATA_SECTION...)
+//encerra a seção, e a sua posição é devolvida em palavra
+static long contaValores(const char *inicio, const char *fim, const char *&palavra)
+{
+       long qtde = 0;
+
+       palavra = NULL;
+       for (const char *p=inicio; p<fim; p++)
+       {
+          if (isEspaco(*p)||((p>inicio)&&!isEspaco(p[-1]))) continue;
+          if (((*p>='A')&&(*p<='Z'))||((*p>='a')&&(*p<='z')))
+          {
+             palavra = p;
+             break;
+          }
+          qtde++;
+       }
+       return qtde;
+}
+
+/*******************************************************
+A seção é dividida em trechos que começam em espaços.
+Cada thread conta os valores do seu trecho e, pela soma
+acumulada das contagens, sabe o índice do primeiro valor
+do trecho. TFormatoPesos::posiciona converte o índice na
+posição (i, j), e os trechos são lidos em paralelo.
+********************************************************/
+bool TMapaGenes::leSecaoPesos(TLeitor &leitor, int numGenes, const std::string &formato)
+{
+       TFormatoPesos formatoPesos(formato, numGenes);
+
+       if (formatoPesos.tipo==TFormatoPesos::invalido)
+       {
+          printf("EDGE_WEIGHT_FORMAT %s não suportado\n", formato.c_str());
+          return false;
+       }
+
+       inicializa (numGenes);
+
+       long qtde = formatoPesos.get_qtde();
+
+       leitor.pulaEspacos();
+       const char *inicio = leitor.get_posicao();
+       const char *fim = leitor.get_fim();
+       int trechos = qtdeTrechos(fim-inicio);
+       std::vector<const char *> limites(trechos+1);
+       std::vector<const char *> palavras(trechos);
+       std::vector<long> qtdeValores(trechos);
+       std::vector<long> primeiro(trechos);
+
+       limites[0] = inicio;
+       limites[trechos] = fim;
+       for (int t=1; t<trechos; t++)
+       {
+          const char *p = inicio + (fim-inicio)*t/trechos;
+          while ((p<fim)&&!isEspaco(*p)) p++;
+          limites[t] = p;
+       }
+
+       #pragma omp parallel for schedule(static, 1)
+       for (int t=0; t<trechos; t++)
+          qtdeValores[t] = contaValores(limites[t], limites[t+1], palavras[t]);
+
+       //Soma acumulada, até o trecho onde a seção termina
+       long total = 0;
+       int usados = trechos;
+       for (int t=0; t<trechos; t++)
+       {
+          primeiro[t] = total;
+          total += qtdeValores[t];
+          if (palavras[t])
+          {
+             usados = t+1;
+             break;
+          }
+       }
+
+       if (total<qtde)
+       {
+          printf("EDGE_WEIGHT_SECTION incompleta: %ld de %ld valores\n", total, qtde);
+          return false;
+       }
+
+       const char *fimSecao = NULL;
+       bool valido = true;
+
+       #pragma omp parallel for schedule(static, 1)
+       for (int t=0; t<usados; t++)
+       {
+          if (primeiro[t]>=qtde) continue;
+
+          TLeitor trecho;
+          TFormatoPesos pos(formato, numGenes);
+          long ultimo = (primeiro[t]+qtdeValores[t]<qtde)?primeiro[t]+qtdeValores[t]:qtde;
+          double valor;
+
+          trecho.abreTrecho(leitor, limites[t], palavras[t]?palavras[t]:limites[t+1]);
+          pos.posiciona(primeiro[t]);
+          for (long k=primeiro[t]; k<ultimo; k++, pos.avanca())
+          {
+             if (!trecho.leNumero(valor))
+             {
+                #pragma omp atomic write
+                valido = false;
+                break;
+             }
+             set_distancia(pos.i, pos.j, valor);
+             if (pos.tipo!=TFormatoPesos::completa) set_distancia(pos.j, pos.i, valor);
+          }
+
+          //Apenas o trecho com o último valor da seção
+          if (ultimo==qtde) fimSecao = trecho.get_posicao();
+       }
+
+       if (!valido)
+       {
+          printf("EDGE_WEIGHT_SECTION com valor inválido\n");
+          return false;
+       }
+       leitor.set_posicao(fimSecao);
+
+       //Escolhendo o armazenamento definitivo da tabela
+       compacta();
+       return true;
+}
+
+bool TMapaGenes::leSecaoCoordenadas(TLeitor &leitor, int numGenes, int tipoDistancia)
+{
+       long id;
+       double x, y;
+
+       inicializaCoordenadas (numGenes, tipoDistancia);
+
+       for (int k=0; k<numGenes; k++)
+       {
+          if (!(leitor.leInteiro(id)&&leitor.leNumero(x)&&leitor.leNumero(y)))
+          {
+             printf("NODE_COORD_SECTION incompleta: %d de %d cidades\n", k, numGenes);
+             return false;
+          }
+          //No TSPLIB as cidades são numeradas a partir de 1
+          set_coordenada((int)id-1, x, y);
+       }
+       return true;
+}
+
+static void pulaNumeros(TLeitor &leitor, long qtde)
+{
+       double valor;
+       for (long k=0; (k<qtde)&&leitor.leNumero(valor); k++);
+}
+
+static int tipoDistanciaTSPLIB(const std::string &tipoPeso)
+{
+       if (tipoPeso=="EXPLICIT") return TMapaGenes::distanciaExplicita;
+       if (tipoPeso=="EUC_2D")   return TMapaGenes::distanciaEUC2D;
+       if (tipoPeso=="CEIL_2D")  return TMapaGenes::distanciaCEIL2D;
+       if (tipoPeso=="ATT")      return TMapaGenes::distanciaATT;
+       if (tipoPeso=="GEO")      return TMapaGenes::distanciaGEO;
+       return -1;
+}
+
+void TMapaGenes::carregaTSPLIB(char *nomeArquivo)
+{
+       TLeitor leitor;
+       std::string chave, valor;
+       std::string formato = "FULL_MATRIX";
+       int numGenes = 0;
+       int tipoDistancia = distanciaExplicita;
+       bool carregou = false;
+       bool erro = false;
+
+       if (!leitor.abre(nomeArquivo))
+       {
+          printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+          return;
+       }
+
+       while ((!erro)&&leitor.lePalavra(chave))
+       {
+          if (chave=="EOF") break;
+
+          if ((chave.find("_SECTION")!=std::string::npos)&&(numGenes<=0))
+          {
+             printf("DIMENSION não informada antes de %s\n", chave.c_str());
+             erro = true;
+          }
+          else if (chave=="NODE_COORD_SECTION")
+          {
+             //Nas instâncias explícitas as coordenadas servem apenas para exibição
+             if (tipoDistancia==distanciaExplicita) pulaNumeros(leitor, 3L*numGenes);
+             else erro = !(carregou = leSecaoCoordenadas(leitor, numGenes, tipoDistancia));
+          }
+          else if (chave=="EDGE_WEIGHT_SECTION")
+          {
+             erro = !(carregou = leSecaoPesos(leitor, numGenes, formato));
+          }
+          else if (chave=="DISPLAY_DATA_SECTION")
+          {
+             pulaNumeros(leitor, 3L*numGenes);
+          }
+          else if (chave=="FIXED_EDGES_SECTION")
+          {
+             long id = 0;
+             while (leitor.leInteiro(id)&&(id!=-1));
+          }
+          else if (chave.find("_SECTION")!=std::string::npos)
+          {
+             printf("Seção %s não suportada\n", chave.c_str());
+             erro = true;
+          }
+          else
+          {
+             //Linha do cabeçalho, "CHAVE : VALOR"
+             leitor.pulaCaractere(':');
+             leitor.leLinha(valor);
+
+             if (chave=="DIMENSION") numGenes = atoi(valor.c_str());
+             else if (chave=="EDGE_WEIGHT_FORMAT") formato = valor;
+             else if (chave=="EDGE_WEIGHT_TYPE")
+             {
+                tipoDistancia = tipoDistanciaTSPLIB(valor);
+                if (tipoDistancia<0)
+                {
+                   printf("EDGE_WEIGHT_TYPE %s não suportado\n", valor.c_str());
+                   erro = true;
+                }
+             }
+             else if ((chave=="TYPE")&&(valor!="TSP")&&(valor!="ATSP"))
+             {
+                printf("Tipo de instância %s não suportado\n", valor.c_str());
+                erro = true;
+             }
+
+             if ((chave=="DIMENSION")&&(numGenes<=0))
+             {
+                printf("DIMENSION inválida: %s\n", valor.c_str());
+                erro = true;
+             }
+          }
+       }
+
+       if ((!carregou)||erro)
+       {
+          printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+          liberaTabela();
+          VP_qtdeGenes = -1;
+       }
+}
+
+void *TMapaGenes::alocaTabela(size_t tamElemento)
+{
+       void *bloco;
 
-       //liberando documento
-       xmlFreeDoc(doc);
-       // liberando as variaveis lobais
-       xmlCleanupParser();
+       if (posix_memalign(&bloco, 64, VP_qtdeElementos*tamElemento) != 0)
+       {
+          printf("Erro ao alocar a tabela de distâncias (%d genes)\n", VP_qtdeGenes);
+          exit(1);
+       }
+       return bloco;
+}
 
+void TMapaGenes::liberaTabela()
+{
+       if (VP_areaMapeada)
+       {
+          //As tabelas apontam para dentro do cache mapeado
+          munmap(VP_areaMapeada, VP_tamMapeado);
+          VP_areaMapeada = NULL;
+          VP_tamMapeado = 0;
+       }
+       else
+       {
+          free (VP_mapaDist);
+          free (VP_mapaDistF);
+          free (VP_mapaDistI);
+          free (VP_mapaDistU);
+          free (VP_x);
+          free (VP_y);
+          free (VP_idOriginal);
+       }
+       VP_idOriginal = NULL;
+       //As listas de candidatos valem apenas para a tabela atual
+       free (VP_candidatos);
+       VP_candidatos = NULL;
+       VP_qtdeCandidatos = 0;
+       delete VP_arvore;
+       VP_arvore = NULL;
+       VP_mapaDist  = NULL;
+       VP_mapaDistF = NULL;
+       VP_mapaDistI = NULL;
+       VP_mapaDistU = NULL;
+       VP_x = NULL;
+       VP_y = NULL;
 }
 
+//Abaixo disto as tabelas são preenchidas sem abrir threads. Os mapas
+//reduzidos do AG recursivo são montados dentro das tarefas paralelas
+static const int minGenesThreads = 512;
+
 void TMapaGenes::inicializa (int numGenes)
 {
-       int i;
-       int j;
+       //Uma nova carga descarta a tabela anterior
+       liberaTabela();
+
        VP_qtdeGenes = numGenes;
-       VP_mapaDist = (double **) malloc(numGenes*sizeof(double *));
+       VP_tipoDistancia = distanciaExplicita;
+       VP_armazenamento = armazenamentoDouble;
+       VP_compactada = false;
+       VP_simetrico = false;
+       VP_inteira = false;
+       VP_escala = 1.0;
+       //Cada linha começa alinhada em 64 bytes, qualquer que seja o armazenamento
+       VP_stride = (numGenes + 31) & ~((size_t)31);
+       VP_qtdeElementos = VP_stride*numGenes;
+
+       VP_mapaDist = (double *) alocaTabela(sizeof(double));
 
-       for (i=0; i<VP_qtdeGenes; i++)
+       #pragma omp parallel for schedule(static) if(VP_qtdeGenes>=minGenesThreads)
+       for (int i=0; i<VP_qtdeGenes; i++)
        {
-          VP_mapaDist [i] = (double *) malloc(numGenes*sizeof(double));
-          for (j=0; j<VP_qtdeGenes; j++)
+          double *linha = VP_mapaDist + i*VP_stride;
+          for (int j=0; j<VP_qtdeGenes; j++)
           {
-             VP_mapaDist[i][j] = infinito; //Inicia Todos os genes com valor infinito na distância
-                                           //ou seja, não tem caminho entre eles
+             linha[j] = infinito; //Inicia Todos os genes com valor infinito na distância
+                                  //ou seja, não tem caminho entre eles
           }
-          VP_mapaDist[i][i] = 0.0; //a distância de um gene para ele mesmo é 0
+          linha[i] = 0.0; //a distância de um gene para ele mesmo é 0
        }
 
 }
 
-TMapaGenes::~TMapaGenes ()
+//Copia a tabela de carga (double, completa) para o layout definitivo.
+//O preenchimento do final de cada linha (stride) não é copiado
+template <typename T>
+static void copiaTabela(T *destino, const double *origem, int qtdeGenes, size_t stride, bool simetrico, double escala, bool arredonda)
 {
-       int i;
+       #pragma omp parallel for schedule(dynamic, 64) if(qtdeGenes>=minGenesThreads)
+       for (int i=0; i<qtdeGenes; i++)
+       {
+          const double *linha = origem + i*stride;
+          int fim = simetrico?i+1:qtdeGenes;
+          size_t k = simetrico?(size_t)i*(i+1)/2:i*stride;
+
+          for (int j=0; j<fim; j++, k++)
+             destino[k] = arredonda?(T) lround(linha[j]/escala):(T) linha[j];
+       }
+}
 
-       for (i=VP_qtdeGenes-1; i>=0; i--)
+void TMapaGenes::compacta ()
+{
+       if ((VP_qtdeGenes<=0)||VP_compactada||is_coordenadas()) return;
+
+       bool inteira = true;
+       bool cabeFloat = true;
+       bool simetrico = true;
+       double maior = 0;
+       double menor = 0;
+
+       #pragma omp parallel for schedule(dynamic, 64) reduction(max:maior) reduction(min:menor) reduction(&&:inteira,cabeFloat,simetrico) if(VP_qtdeGenes>=minGenesThreads)
+       for (int i=0; i<VP_qtdeGenes; i++)
        {
-          free (VP_mapaDist [i]);
+          double *linha = VP_mapaDist + i*VP_stride;
+          for (int j=0; j<VP_qtdeGenes; j++)
+          {
+             double d = linha[j];
+             if (d>maior) maior = d;
+             if (d<menor) menor = d;
+             if (d!=(double)(long)d) inteira = false;
+             if (d!=(double)(float)d) cabeFloat = false;
+             if ((j<i)&&(d!=VP_mapaDist[j*VP_stride + i])) simetrico = false;
+          }
        }
 
-       if (VP_qtdeGenes>0) free (VP_mapaDist);
+       int modo = VP_armazenamentoPedido;
+       if (modo==armazenamentoAuto)
+       {
+          if (inteira && (menor>=0) && (maior<=65535)) modo = armazenamentoUInt16;
+          else if (inteira && (maior<=2147483647.0) && (menor>=-2147483647.0)) modo = armazenamentoInt32;
+          else if (cabeFloat) modo = armazenamentoFloat;
+          else                modo = armazenamentoDouble;
+       }
 
- }
+       //Ao forçar um armazenamento inteiro, as distâncias não inteiras são arredondadas
+       //e, em uint16, as maiores que 65535 são quantizadas em passos de VP_escala
+       if (((modo==armazenamentoInt32)||(modo==armazenamentoUInt16))&&(!inteira))
+          printf("Aviso: distâncias não inteiras serão arredondadas no armazenamento %s\n", (modo==armazenamentoInt32)?"int32":"uint16");
+
+       double escala = 1.0;
+       if ((modo==armazenamentoUInt16)&&(maior>65535)) escala = maior/65535;
+
+       //Matriz completa em double já está no layout definitivo
+       if ((modo==armazenamentoDouble)&&(!simetrico))
+       {
+          VP_compactada = true;
+          return;
+       }
+
+       double *origem = VP_mapaDist;
+       VP_mapaDist = NULL;
+       if (simetrico) VP_qtdeElementos = (size_t)VP_qtdeGenes*(VP_qtdeGenes+1)/2;
+
+       switch (modo)
+       {
+          case armazenamentoFloat:
+          {
+             VP_mapaDistF = (float *) alocaTabela(sizeof(float));
+             copiaTabela(VP_mapaDistF, origem, VP_qtdeGenes, VP_stride, simetrico, 1.0, false);
+             break;
+          }
+          case armazenamentoInt32:
+          {
+             VP_mapaDistI = (int32_t *) alocaTabela(sizeof(int32_t));
+             copiaTabela(VP_mapaDistI, origem, VP_qtdeGenes, VP_stride, simetrico, 1.0, true);
+             break;
+          }
+          case armazenamentoUInt16:
+          {
+             VP_mapaDistU = (uint16_t *) alocaTabela(sizeof(uint16_t));
+             copiaTabela(VP_mapaDistU, origem, VP_qtdeGenes, VP_stride, simetrico, escala, true);
+             break;
+          }
+          default:
+          {
+             VP_mapaDist = (double *) alocaTabela(sizeof(double));
+             copiaTabela(VP_mapaDist, origem, VP_qtdeGenes, VP_stride, simetrico, 1.0, false);
+             break;
+          }
+       }
+
+       free (origem);
+       VP_armazenamento = modo;
+       VP_simetrico = simetrico;
+       VP_compactada = true;
+       VP_escala = escala;
+       VP_inteira = (modo==armazenamentoInt32)||((modo==armazenamentoUInt16)&&(escala==1.0));
+}
+
+void TMapaGenes::inicializaCoordenadas (int numGenes, int tipoDistancia)
+{
+       liberaTabela();
+
+       VP_qtdeGenes = numGenes;
+       VP_tipoDistancia = tipoDistancia;
+       VP_armazenamento = armazenamentoDouble;
+       VP_compactada = true;
+       VP_simetrico = true;
+       VP_inteira = true; //Todas as fórmulas do TSPLIB arredondam para inteiro
+       VP_escala = 1.0;
+       VP_stride = 0;
+       VP_qtdeElementos = (numGenes + 7) & ~((size_t)7);
+
+       VP_x = (double *) alocaTabela(sizeof(double));
+       VP_y = (double *) alocaTabela(sizeof(double));
+       for (size_t i=0; i<VP_qtdeElementos; i++)
+       {
+          VP_x[i] = 0.0;
+          VP_y[i] = 0.0;
+       }
+}
+
+//Graus.minutos do TSPLIB para radianos
+static double radianosGeo(double v)
+{
+       const double PI = 3.141592;
+       int graus = (int) v;
+       double minutos = v - graus;
+       return PI * (graus + 5.0 * minutos / 3.0) / 180.0;
+}
+
+void TMapaGenes::set_coordenada (int gene, double x, double y)
+{
+       if ((gene<0)||(gene>=VP_qtdeGenes)||(!is_coordenadas())) return;
+       if (VP_areaMapeada) copiaMapeada();
+
+       if (VP_tipoDistancia==distanciaGEO)
+       {
+          x = radianosGeo(x);
+          y = radianosGeo(y);
+       }
+       VP_x[gene] = x;
+       VP_y[gene] = y;
+}
+
+double TMapaGenes::distanciaGeo(int geneOri, int geneDest) const
+{
+       const double RRR = 6378.388;
+       double q1 = cos(VP_y[geneOri] - VP_y[geneDest]);
+       double q2 = cos(VP_x[geneOri] - VP_x[geneDest]);
+       double q3 = cos(VP_x[geneOri] + VP_x[geneDest]);
+       return (double)(int)(RRR * acos(0.5*((1.0+q1)*q2 - (1.0-q1)*q3)) + 1.0);
+}
+
+//Fórmulas sem desvio, para que os laços abaixo sejam vetorizados.
+//As distâncias são positivas e cabem em int, então o truncamento
+//por (int) equivale ao floor e tem instrução vetorial no SSE2
+template <int tipo>
+static inline double formulaCoord(double xd, double yd)
+{
+       double q = xd*xd + yd*yd;
+       if (tipo==TMapaGenes::distanciaEUC2D) return (double)(int)(sqrt(q) + 0.5);
+       double r = (tipo==TMapaGenes::distanciaCEIL2D)?sqrt(q):sqrt(q/10.0);
+       double t = (tipo==TMapaGenes::distanciaCEIL2D)?(double)(int)r:(double)(int)(r + 0.5);
+       return t + ((t<r)?1.0:0.0);
+}
+
+template <int tipo>
+static void linhaCoord(double xo, double yo, const double * __restrict__ x, const double * __restrict__ y, int qtde, double * __restrict__ saida)
+{
+       for (int j=0; j<qtde; j++)
+          saida[j] = formulaCoord<tipo>(xo - x[j], yo - y[j]);
+}
+
+template <int tipo>
+static void listaCoord(double xo, double yo, const double * __restrict__ x, const double * __restrict__ y, const int * __restrict__ genesDest, int qtde, double * __restrict__ saida)
+{
+       for (int j=0; j<qtde; j++)
+          saida[j] = formulaCoord<tipo>(xo - x[genesDest[j]], yo - y[genesDest[j]]);
+}
+
+void TMapaGenes::get_distancias(int geneOri, double *saida) const
+{
+       switch (VP_tipoDistancia)
+       {
+          case distanciaEUC2D:
+             linhaCoord<distanciaEUC2D>(VP_x[geneOri], VP_y[geneOri], VP_x, VP_y, VP_qtdeGenes, saida);
+             break;
+          case distanciaCEIL2D:
+             linhaCoord<distanciaCEIL2D>(VP_x[geneOri], VP_y[geneOri], VP_x, VP_y, VP_qtdeGenes, saida);
+             break;
+          case distanciaATT:
+             linhaCoord<distanciaATT>(VP_x[geneOri], VP_y[geneOri], VP_x, VP_y, VP_qtdeGenes, saida);
+             break;
+          default:
+             for (int j=0; j<VP_qtdeGenes; j++) saida[j] = get_distancia(geneOri, j);
+             break;
+       }
+       saida[geneOri] = 0.0;
+}
+
+void TMapaGenes::get_distancias(int geneOri, const int *genesDest, int qtde, double *saida) const
+{
+       switch (VP_tipoDistancia)
+       {
+          case distanciaEUC2D:
+             listaCoord<distanciaEUC2D>(VP_x[geneOri], VP_y[geneOri], VP_x, VP_y, genesDest, qtde, saida);
+             break;
+          case distanciaCEIL2D:
+             listaCoord<distanciaCEIL2D>(VP_x[geneOri], VP_y[geneOri], VP_x, VP_y, genesDest, qtde, saida);
+             break;
+          case distanciaATT:
+             listaCoord<distanciaATT>(VP_x[geneOri], VP_y[geneOri], VP_x, VP_y, genesDest, qtde, saida);
+             break;
+          default:
+             for (int j=0; j<qtde; j++) saida[j] = get_distancia(geneOri, genesDest[j]);
+             return;
+       }
+       //A diagonal não passa pela fórmula sem desvio
+       for (int j=0; j<qtde; j++)
+          if (genesDest[j]==geneOri) saida[j] = 0.0;
+}
+
+void TMapaGenes::selecionaCandidatos(int gene, int qtde, int qtdeQuadrante, double *dist, int *ordem, int *lista)
+{
+       int m = 0;
+       int qtdeLista = 0;
+
+       //Empates são desfeitos pelo número do gene, para que as listas
+       //não dependam da ordenação nem do número de threads
+       auto menor = [dist](int a, int b) { return (dist[a]<dist[b])||((dist[a]==dist[b])&&(a<b)); };
+
+       if (VP_arvore)
+       {
+          //Os mais próximos de cada quadrante e os mais próximos no geral.
+          //Os qtde mais próximos sempre bastam para completar a lista
+          if (qtdeQuadrante>0)
+             for (int q=0; q<4; q++)
+                qtdeLista += VP_arvore->maisProximos(VP_x[gene], VP_y[gene], qtdeQuadrante, gene, lista+qtdeLista, q);
+
+          int reservados = qtdeLista;
+          m = VP_arvore->maisProximos(VP_x[gene], VP_y[gene], qtde, gene, ordem);
+          for (int k=0; (k<m)&&(qtdeLista<qtde); k++)
+             if (std::find(lista, lista+reservados, ordem[k])==lista+reservados) lista[qtdeLista++] = ordem[k];
+
+          for (int k=0; k<qtde; k++) dist[lista[k]] = get_distancia(gene, lista[k]);
+          std::sort(lista, lista+qtde, menor);
+          return;
+       }
+
+       get_distancias(gene, dist);
+       for (int j=0; j<VP_qtdeGenes; j++)
+          if (j!=gene) ordem[m++] = j;
+
+       if (qtdeQuadrante<=0)
+       {
+          std::partial_sort(ordem, ordem+qtde, ordem+m, menor);
+          for (int k=0; k<qtde; k++) lista[k] = ordem[k];
+          return;
+       }
+
+       //Primeiro os mais próximos de cada quadrante, depois os mais
+       //próximos no geral, até completar a lista
+       int porQuadrante[4] = { 0, 0, 0, 0 };
+
+       std::sort(ordem, ordem+m, menor);
+       for (int k=0; (k<m)&&(qtdeLista<4*qtdeQuadrante); k++)
+       {
+          int j = ordem[k];
+          int q = ((VP_x[j]>=VP_x[gene])?0:1) + ((VP_y[j]>=VP_y[gene])?0:2);
+
+          if (porQuadrante[q]<qtdeQuadrante)
+          {
+             porQuadrante[q]++;
+             lista[qtdeLista++] = j;
+             ordem[k] = -1;
+          }
+       }
+       for (int k=0; (k<m)&&(qtdeLista<qtde); k++)
+          if (ordem[k]>=0) lista[qtdeLista++] = ordem[k];
+
+       std::sort(lista, lista+qtde, menor);
+}
+
+void TMapaGenes::geraCandidatos (int qtde, int qtdeQuadrante)
+{
+       free (VP_candidatos);
+       VP_candidatos = NULL;
+       VP_qtdeCandidatos = 0;
+
+       if ((qtde<=0)||(VP_qtdeGenes<=1)) return;
+       if (qtde>VP_qtdeGenes-1) qtde = VP_qtdeGenes-1;
+       if (!is_coordenadas()) qtdeQuadrante = 0;
+       if (4*qtdeQuadrante>qtde) qtdeQuadrante = qtde/4;
+
+       VP_candidatos = (int *) malloc(sizeof(int)*(size_t)VP_qtdeGenes*qtde);
+       if (VP_candidatos == NULL)
+       {
+          printf("Erro ao alocar as listas de candidatos (%d genes)\n", VP_qtdeGenes);
+          exit(1);
+       }
+       get_arvore();
+
+       #pragma omp parallel
+       {
+          std::vector<double> dist(VP_qtdeGenes);
+          std::vector<int> ordem(VP_qtdeGenes);
+
+          #pragma omp for schedule(dynamic, 64)
+          for (int i=0; i<VP_qtdeGenes; i++)
+             selecionaCandidatos(i, qtde, qtdeQuadrante, dist.data(), ordem.data(), VP_candidatos + (size_t)i*qtde);
+       }
+
+       VP_qtdeCandidatos = qtde;
+}
+
+const TKdTree *TMapaGenes::get_arvore ()
+{
+       if ((VP_arvore==NULL)&&(VP_qtdeGenes>0)&&
+           ((VP_tipoDistancia==distanciaEUC2D)||(VP_tipoDistancia==distanciaCEIL2D)||(VP_tipoDistancia==distanciaATT)))
+       {
+          VP_arvore = new TKdTree();
+          VP_arvore->constroi(VP_x, VP_y, VP_qtdeGenes);
+       }
+       return VP_arvore;
+}
+
+void TMapaGenes::rotaVizinhoMaisProximo (int *rota)
+{
+       if (VP_qtdeGenes<=0) return;
+       rota[0] = 0;
+
+       if (get_arvore())
+       {
+          //Cada gene visitado sai da árvore, e a árvore volta inteira no final
+          VP_arvore->remove(0);
+          for (int i=1; i<VP_qtdeGenes; i++)
+          {
+             rota[i] = VP_arvore->maisProximo(VP_x[rota[i-1]], VP_y[rota[i-1]], -1);
+             VP_arvore->remove(rota[i]);
+          }
+          VP_arvore->restaura();
+          return;
+       }
+
+       std::vector<double> dist(VP_qtdeGenes);
+       std::vector<char> visitado(VP_qtdeGenes, 0);
+       visitado[0] = 1;
+       for (int i=1; i<VP_qtdeGenes; i++)
+       {
+          int melhor = -1;
+          get_distancias(rota[i-1], dist.data());
+          for (int j=0; j<VP_qtdeGenes; j++)
+             if ((!visitado[j])&&((melhor<0)||(dist[j]<dist[melhor]))) melhor = j;
+          rota[i] = melhor;
+          visitado[melhor] = 1;
+       }
+}
+
+//Posição do ponto (x,y), em uma grade de 2^16 x 2^16, ao longo da curva de Hilbert
+static uint64_t indiceHilbert(uint32_t x, uint32_t y)
+{
+       const uint32_t lado = 1u<<16;
+       uint64_t d = 0;
+
+       for (uint32_t s=lado/2; s>0; s/=2)
+       {
+          uint32_t rx = (x & s)?1:0;
+          uint32_t ry = (y & s)?1:0;
+          d += (uint64_t)s*s*((3*rx)^ry);
+
+          //Gira o quadrante, para que a curva continue sem saltos
+          if (ry==0)
+          {
+             if (rx==1)
+             {
+                x = lado-1 - x;
+                y = lado-1 - y;
+             }
+             uint32_t t = x; x = y; y = t;
+          }
+       }
+       return d;
+}
+
+//Cidades na ordem da curva de Hilbert. A mesma escala nos dois eixos
+//mantém a proporção da instância
+void TMapaGenes::ordemHilbert(int *ordem)
+{
+       double xMin = VP_x[0], xMax = VP_x[0];
+       double yMin = VP_y[0], yMax = VP_y[0];
+       for (int i=1; i<VP_qtdeGenes; i++)
+       {
+          if (VP_x[i]<xMin) xMin = VP_x[i];
+          if (VP_x[i]>xMax) xMax = VP_x[i];
+          if (VP_y[i]<yMin) yMin = VP_y[i];
+          if (VP_y[i]>yMax) yMax = VP_y[i];
+       }
+       double amplitude = ((xMax-xMin)>(yMax-yMin))?xMax-xMin:yMax-yMin;
+       double escala = (amplitude>0)?65535.0/amplitude:0.0;
+
+       std::vector< std::pair<uint64_t, int> > chaves(VP_qtdeGenes);
+
+       #pragma omp parallel for schedule(static)
+       for (int i=0; i<VP_qtdeGenes; i++)
+          chaves[i] = std::make_pair(indiceHilbert((uint32_t)((VP_x[i]-xMin)*escala), (uint32_t)((VP_y[i]-yMin)*escala)), i);
+
+       std::sort(chaves.begin(), chaves.end());
+       for (int i=0; i<VP_qtdeGenes; i++) ordem[i] = chaves[i].second;
+}
+
+//Nova tabela com a cidade i no lugar da cidade ordem[i]
+template <typename T>
+static T *permutaTabela(const T *origem, T *destino, const int *ordem, int qtdeGenes, size_t stride, bool simetrico)
+{
+       #pragma omp parallel for schedule(dynamic, 64)
+       for (int i=0; i<qtdeGenes; i++)
+       {
+          int fim = simetrico?i+1:qtdeGenes;
+          size_t k = simetrico?(size_t)i*(i+1)/2:i*stride;
+          int a = ordem[i];
+
+          for (int j=0; j<fim; j++, k++)
+          {
+             int b = ordem[j];
+             if (!simetrico)  destino[k] = origem[(size_t)a*stride + b];
+             else if (a>=b)   destino[k] = origem[(size_t)a*(a+1)/2 + b];
+             else             destino[k] = origem[(size_t)b*(b+1)/2 + a];
+          }
+       }
+       return destino;
+}
+
+void TMapaGenes::renumera()
+{
+       std::vector<int> ordem(VP_qtdeGenes);
+
+       if (is_coordenadas())
+       {
+          ordemHilbert(ordem.data());
+
+          double *x = (double *) alocaTabela(sizeof(double));
+          double *y = (double *) alocaTabela(sizeof(double));
+          for (size_t i=0; i<VP_qtdeElementos; i++)
+          {
+             x[i] = (i<(size_t)VP_qtdeGenes)?VP_x[ordem[i]]:0.0;
+             y[i] = (i<(size_t)VP_qtdeGenes)?VP_y[ordem[i]]:0.0;
+          }
+          free (VP_x);
+          free (VP_y);
+          VP_x = x;
+          VP_y = y;
+       }
+       else
+       {
+          rotaVizinhoMaisProximo(ordem.data());
+
+          switch (VP_armazenamento)
+          {
+             case armazenamentoFloat:
+             {
+                float *origem = VP_mapaDistF;
+                VP_mapaDistF = permutaTabela(origem, (float *) alocaTabela(sizeof(float)), ordem.data(), VP_qtdeGenes, VP_stride, VP_simetrico);
+                free (origem);
+                break;
+             }
+             case armazenamentoInt32:
+             {
+                int32_t *origem = VP_mapaDistI;
+                VP_mapaDistI = permutaTabela(origem, (int32_t *) alocaTabela(sizeof(int32_t)), ordem.data(), VP_qtdeGenes, VP_stride, VP_simetrico);
+                free (origem);
+                break;
+             }
+             case armazenamentoUInt16:
+             {
+                uint16_t *origem = VP_mapaDistU;
+                VP_mapaDistU = permutaTabela(origem, (uint16_t *) alocaTabela(sizeof(uint16_t)), ordem.data(), VP_qtdeGenes, VP_stride, VP_simetrico);
+                free (origem);
+                break;
+             }
+             default:
+             {
+                double *origem = VP_mapaDist;
+                VP_mapaDist = permutaTabela(origem, (double *) alocaTabela(sizeof(double)), ordem.data(), VP_qtdeGenes, VP_stride, VP_simetrico);
+                free (origem);
+                break;
+             }
+          }
+       }
+
+       //Listas e árvore montadas antes da renumeração não valem mais
+       free (VP_candidatos);
+       VP_candidatos = NULL;
+       VP_qtdeCandidatos = 0;
+       delete VP_arvore;
+       VP_arvore = NULL;
+
+       free (VP_idOriginal);
+       VP_idOriginal = (int32_t *) malloc(sizeof(int32_t)*VP_qtdeGenes);
+       for (int i=0; i<VP_qtdeGenes; i++) VP_idOriginal[i] = ordem[i];
+}
+
+TMapaGenes::~TMapaGenes ()
+{
+       liberaTabela();
+}
 
 void TMapaGenes::set_distancia(int geneOri, int geneDest, double distancia)
 {
        //a distância do gene para ele mesmo não pode ser alterada
        //nenum gene pode está fora do indice d tabela
-       if ((geneOri!=geneDest)&&(geneOri>=0)&&(geneOri<VP_qtdeGenes)&&(geneDest>=0)&&(geneDest<VP_qtdeGenes))
-          VP_mapaDist[geneOri][geneDest] = distancia;
+       //Nas coordenadas, as distâncias são sempre calculadas
+       if (is_coordenadas()||(geneOri==geneDest)||(geneOri<0)||(geneOri>=VP_qtdeGenes)||(geneDest<0)||(geneDest>=VP_qtdeGenes)) return;
+       if (VP_areaMapeada) copiaMapeada();
+
+       //Na tabela simétrica, altera as duas direções
+       size_t k = posicao(geneOri, geneDest);
+       switch (VP_armazenamento)
+       {
+          case armazenamentoFloat:  VP_mapaDistF[k] = (float) distancia;                  break;
+          case armazenamentoInt32:  VP_mapaDistI[k] = (int32_t) lround(distancia);        break;
+          case armazenamentoUInt16: VP_mapaDistU[k] = (uint16_t) lround(distancia/VP_escala); break;
+          default:                  VP_mapaDist[k]  = distancia;                          break;
+       }
 }
 
-double TMapaGenes::get_distancia(int geneOri, int geneDest)
+#ifdef TSP_DEBUG
+double TMapaGenes::get_distanciaVerificada(int geneOri, int geneDest) const
 {
        //nenum gene pode está fora do indice d tabela
-       if ((geneOri<VP_qtdeGenes)&&(geneDest>=0)&&(geneDest<VP_qtdeGenes))
-          return VP_mapaDist[geneOri][geneDest];
-       else
-          return 0.0;
+       if ((geneOri<0)||(geneOri>=VP_qtdeGenes)||(geneDest<0)||(geneDest>=VP_qtdeGenes))
+       {
+          fprintf(stderr, "get_distancia fora da tabela: (%d, %d) com %d genes\n", geneOri, geneDest, VP_qtdeGenes);
+          abort();
+       }
+       if (VP_tipoDistancia!=distanciaExplicita) return calcula(geneOri, geneDest);
+       return le(posicao(geneOri, geneDest));
 }
+#endif
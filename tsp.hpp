@@ -15,23 +15,181 @@
 
 
 #include "tipos.cpp"
-#include <libxml/parser.h>
-#include <libxml/tree.h>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <cmath>
+class TLeitor;
+class TKdTree;
 
 /*******************************************************
 classe de TMapaGenes. Todas as distâncias entre os genes
+As distâncias ficam em um único bloco contíguo, alinhado
+à linha de cache, e cada linha da matriz começa alinhada
+(VP_stride é múltiplo de 32 elementos).
+
+Durante a carga a tabela é sempre double. Ao final,
+compacta() escolhe o tipo definitivo do armazenamento:
+   - uint16, quando as distâncias são inteiras e cabem
+     em 16 bits (ou quantizadas, se for forçado);
+   - int32, quando as distâncias são inteiras;
+   - float, quando nenhum valor perde precisão;
+   - double, nos demais casos.
+Se a matriz for simétrica, apenas o triângulo inferior
+(com a diagonal) é guardado, linha a linha.
+
+Instâncias por coordenadas (NODE_COORD do TSPLIB: EUC_2D,
+CEIL_2D, ATT e GEO) não alocam matriz. Guardam apenas x[]
+e y[] em vetores separados e calculam cada distância no
+momento do acesso, com as fórmulas do TSPLIB. Para GEO,
+x e y já são guardados como latitude/longitude em radianos.
+
+Após a carga, a tabela já no layout definitivo é gravada em
+um cache binário (<instância>.cache). Nas cargas seguintes
+o cache é mapeado apenas para leitura (mmap), e processos
+simultâneos na mesma máquina compartilham as mesmas páginas.
+O cache é refeito quando o arquivo da instância muda ou
+quando outro armazenamento é solicitado.
+
+Depois da carga podem ser geradas as listas de candidatos:
+para cada gene, os k genes mais próximos (pela distância
+de saída), em ordem crescente. Nas coordenadas, parte da
+lista pode ser reservada aos mais próximos de cada um dos
+quatro quadrantes em volta do gene, o que evita listas
+concentradas em um só lado nas instâncias agrupadas.
+Nas coordenadas no plano (EUC_2D, CEIL_2D e ATT) as listas
+e a rota do vizinho mais próximo usam uma árvore k-d, e o
+pré-processamento fica em O(n log n). Nas demais (GEO e
+explícitas) a busca percorre todas as distâncias.
+
+Opcionalmente as cidades são renumeradas na carga, para
+que cidades próximas tenham números próximos: pela curva
+de Hilbert nas coordenadas, ou pela rota do vizinho mais
+próximo nas explícitas (a matriz é permutada). Assim as
+boas rotas percorrem a memória quase em sequência. O
+número original de cada cidade é mantido para a saída
+(get_idOriginal) e gravado junto no cache.
 ********************************************************/
 class TMapaGenes
 {
+   public:
+      static const int armazenamentoAuto   = 0;
+      static const int armazenamentoDouble = 1;
+      static const int armazenamentoFloat  = 2;
+      static const int armazenamentoInt32  = 3;
+      static const int armazenamentoUInt16 = 4;
+
+      static const int distanciaExplicita = 0;
+      static const int distanciaEUC2D     = 1;
+      static const int distanciaCEIL2D    = 2;
+      static const int distanciaATT       = 3;
+      static const int distanciaGEO       = 4;
+
+      static const int renumeracaoNenhuma = 0;
+      static const int renumeracaoAuto    = 1; //Hilbert nas coordenadas, vizinho mais próximo nas explícitas
+
    private:
-      double **VP_mapaDist;
+      //Apenas um dos ponteiros é válido, conforme VP_armazenamento.
+      //Todos apontam para o mesmo bloco alinhado
+      double   *VP_mapaDist;
+      float    *VP_mapaDistF;
+      int32_t  *VP_mapaDistI;
+      uint16_t *VP_mapaDistU;
+
+      size_t VP_stride;
+      size_t VP_qtdeElementos;
       int VP_qtdeGenes;
+      bool VP_compactada;         //Tabela já está no armazenamento definitivo
+      bool VP_simetrico;          //Guardada como triângulo inferior
+
+      int VP_armazenamento;       //Armazenamento em uso
+      int VP_armazenamentoPedido; //Armazenamento solicitado antes da carga
+      bool VP_inteira;            //Todas as distâncias são inteiras
+      double VP_escala;           //Passo da quantização em uint16 (1 quando exato)
+
+      int VP_tipoDistancia;       //distanciaExplicita ou o tipo das coordenadas
+      double *VP_x;               //Coordenadas, apenas quando não é explícita
+      double *VP_y;
+
+      bool VP_usaCache;
+      void *VP_areaMapeada;       //Cache mapeado. Quando não nulo, as tabelas
+      size_t VP_tamMapeado;       //apontam para dentro dele e não são liberadas com free
+
+      int VP_qtdeCandidatos;      //k, 0 quando as listas não foram geradas
+      int *VP_candidatos;         //k candidatos por gene, linha a linha
+
+      TKdTree *VP_arvore;         //Índice espacial, apenas nas coordenadas no plano
+
+      int VP_renumeracaoPedida;   //Renumeração solicitada antes da carga
+      int32_t *VP_idOriginal;     //Número na instância de cada cidade, NULL sem renumeração
 
    //Metodos Privados
-   int getNumGeneDoArquivo(xmlDocPtr doc, xmlNode * a_node);
-   void preencheMapaDist (int geneOri, xmlDocPtr doc, xmlNode * a_node);
+   void preencheMapaDist (int geneOri, TLeitor &leitor, const char *fimVertice);
+
+   //Formatos de entrada
+   void carregaXML(char *nomeArquivo);
+   void carregaTSPLIB(char *nomeArquivo);
+   bool leSecaoPesos(TLeitor &leitor, int numGenes, const std::string &formato);
+   bool leSecaoCoordenadas(TLeitor &leitor, int numGenes, int tipoDistancia);
+
+   void *alocaTabela(size_t tamElemento);
+   void liberaTabela();
+
+   //Cache binário da instância
+   size_t get_tamanhoBloco();
+   bool carregaCache(const std::string &nomeCache, const char *nomeArquivo);
+   void gravaCache(const std::string &nomeCache, const char *nomeArquivo);
+   void copiaMapeada();
 
-   void preencheMapa(xmlDocPtr doc, xmlNode * a_node);
+   //Renumeração das cidades, logo após a carga da instância
+   void renumera();
+   void ordemHilbert(int *ordem);
+
+   void selecionaCandidatos(int gene, int qtde, int qtdeQuadrante, double *dist, int *ordem, int *lista);
+
+   inline size_t posicao(int geneOri, int geneDest) const
+   {
+      if (VP_simetrico)
+      {
+         if (geneOri<geneDest) { int t = geneOri; geneOri = geneDest; geneDest = t; }
+         return (size_t)geneOri*(geneOri+1)/2 + geneDest;
+      }
+      return geneOri*VP_stride + geneDest;
+   }
+
+   inline double le(size_t k) const
+   {
+      switch (VP_armazenamento)
+      {
+         case armazenamentoFloat:  return VP_mapaDistF[k];
+         case armazenamentoInt32:  return VP_mapaDistI[k];
+         case armazenamentoUInt16: return VP_mapaDistU[k]*VP_escala;
+         default:                  return VP_mapaDist[k];
+      }
+   }
+
+   //Distância entre dois genes pelas coordenadas, conforme TSPLIB
+   inline double calcula(int geneOri, int geneDest) const
+   {
+      if (geneOri==geneDest) return 0;
+
+      double xd = VP_x[geneOri] - VP_x[geneDest];
+      double yd = VP_y[geneOri] - VP_y[geneDest];
+      switch (VP_tipoDistancia)
+      {
+         case distanciaEUC2D:  return (double)(int)(sqrt(xd*xd + yd*yd) + 0.5);
+         case distanciaCEIL2D: return ceil(sqrt(xd*xd + yd*yd));
+         case distanciaATT:
+         {
+            double r = sqrt((xd*xd + yd*yd)/10.0);
+            double t = (double)(int)(r + 0.5);
+            return (t<r)?t+1:t;
+         }
+         default: return distanciaGeo(geneOri, geneDest);
+      }
+   }
+
+   double distanciaGeo(int geneOri, int geneDest) const;
 
    public:
       TMapaGenes ();
@@ -40,15 +198,91 @@ class TMapaGenes
 
       int get_qtdeGenes ();
 
+      //Aceita o XML convertido ou o formato TSPLIB (.tsp/.atsp)
       void carregaDoArquivo(char *nomeArquivo);
 
       void inicializa (int numGenes);
 
+      //Escolhe o armazenamento definitivo, após a carga
+      void compacta ();
+
+      //Prepara uma instância por coordenadas, sem matriz
+      void inicializaCoordenadas (int numGenes, int tipoDistancia);
+      void set_coordenada (int gene, double x, double y);
+      int get_tipoDistancia ();
+      bool is_coordenadas ();
+      std::string get_nomeTipoDistancia ();
+
       ~TMapaGenes ();
 
+      //Devem ser informados antes da carga
+      void set_armazenamento (int armazenamento);
+      void set_usaCache (bool usaCache);
+      void set_renumeracao (int renumeracao);
+      bool is_mapeado ();
+      int get_armazenamento ();
+      std::string get_nomeArmazenamento ();
+      size_t get_tamanhoTabela ();
+      bool is_inteira ();
+      bool is_simetrico ();
+
+      //Número da cidade no arquivo da instância
+      bool is_renumerado ();
+      inline int get_idOriginal (int gene) const { return VP_idOriginal?VP_idOriginal[gene]:gene; }
+
       void set_distancia(int geneOri, int geneDest, double distancia);
 
-      double get_distancia(int geneOri, int geneDest);
+      //Acesso sem verificação de limites, pois é o ponto mais
+      //utilizado do programa. Compilando com -DTSP_DEBUG, todo
+      //acesso passa pela versão verificada.
+      inline double get_distancia(int geneOri, int geneDest) const
+      {
+#ifdef TSP_DEBUG
+         return get_distanciaVerificada(geneOri, geneDest);
+#else
+         if (VP_tipoDistancia!=distanciaExplicita) return calcula(geneOri, geneDest);
+         return le(posicao(geneOri, geneDest));
+#endif
+      }
+
+      //Para as tabelas inteiras (is_inteira), permite a soma sem
+      //conversões de ponto flutuante
+      inline long get_distanciaInt(int geneOri, int geneDest) const
+      {
+         if (VP_tipoDistancia!=distanciaExplicita) return (long) get_distancia(geneOri, geneDest);
+         size_t k = posicao(geneOri, geneDest);
+         switch (VP_armazenamento)
+         {
+            case armazenamentoInt32:  return VP_mapaDistI[k];
+            case armazenamentoUInt16: return VP_mapaDistU[k];
+            default:                  return (long) get_distancia(geneOri, geneDest);
+         }
+      }
+
+      //Listas de candidatos. qtdeQuadrante vale apenas para coordenadas
+      //e é limitado a qtde/4
+      void geraCandidatos (int qtde, int qtdeQuadrante);
+      inline int get_qtdeCandidatos () const { return VP_qtdeCandidatos; }
+      inline const int *get_candidatos (int gene) const { return VP_candidatos + (size_t)gene*VP_qtdeCandidatos; }
+
+      //Árvore k-d dos genes, montada na primeira chamada. Nula quando as
+      //distâncias não são euclidianas no plano. Deve ser chamada antes
+      //de ser usada por várias threads
+      const TKdTree *get_arvore ();
+
+      //Rota gulosa: a partir do gene 0, sempre o mais próximo ainda não
+      //visitado. rota deve ter get_qtdeGenes posições
+      void rotaVizinhoMaisProximo (int *rota);
+
+      //Distâncias de geneOri para todos os genes (saida com get_qtdeGenes
+      //posições) ou para uma lista de destinos. Nas coordenadas o laço
+      //percorre x[] e y[] em sequência e é vetorizado pelo compilador
+      void get_distancias(int geneOri, double *saida) const;
+      void get_distancias(int geneOri, const int *genesDest, int qtde, double *saida) const;
+
+#ifdef TSP_DEBUG
+      double get_distanciaVerificada(int geneOri, int geneDest) const;
+#endif
 
 };
 
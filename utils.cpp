@@ -19,14 +19,45 @@ double TUtils::fatorialStirling (int n)
    return result;
 }
 
+double TUtils::esforcoHeldKarp (int n)
+{
+   if (n<=0) return 0;
+   return (double)n*n*pow(2.0, n);
+}
+
+//Estado do gerador da thread, nunca 0
+static thread_local uint64_t estadoRnd = 88172645463325252ULL;
+
+static uint64_t proximoRnd ()
+{
+   estadoRnd ^= estadoRnd >> 12;
+   estadoRnd ^= estadoRnd << 25;
+   estadoRnd ^= estadoRnd >> 27;
+   return estadoRnd * 2685821657736338717ULL;
+}
+
 void TUtils::initRnd ()
 {
-   srand(time(NULL));
+   initRnd(time(NULL));
 }
 
+void TUtils::initRnd (uint64_t semente)
+{
+   //splitmix64, para sementes próximas darem estados distantes
+   uint64_t z = semente + 0x9E3779B97F4A7C15ULL;
+   z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+   z ^= z >> 31;
+   estadoRnd = (z!=0)?z:88172645463325252ULL;
+}
+
+uint64_t TUtils::sorteiaSemente ()        { return proximoRnd(); }
+uint64_t TUtils::get_estadoRnd ()         { return estadoRnd; }
+void TUtils::set_estadoRnd (uint64_t estado) { estadoRnd = estado; }
+
 int TUtils::rnd(unsigned low, unsigned high)
 {
-   return rand() % (high-low+1) + low;
+   return (proximoRnd() >> 33) % (high-low+1) + low;
 }
 
 double TUtils::rndd(double low, double high)
@@ -37,7 +68,7 @@ double TUtils::rndd(double low, double high)
 double TUtils::rndd(double low, double high, unsigned calibracao)
 {
 	//Gerando um número randomico entre 0 e VP_MaxrndD
-   unsigned r = rand() % calibracao;
+   unsigned r = (proximoRnd() >> 33) % calibracao;
 	
 	//Após achar um randomico entre 0 e VP_MaxrndD
 	//vou converter para a escala entre low e high
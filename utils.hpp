@@ -1,6 +1,7 @@
 
 #include <random>
 #include <chrono>
+#include <stdint.h>
 
 #ifndef _UTIL_H
 #define	_UTIL_H
@@ -16,7 +17,20 @@ class TUtils
       ************************************************************************************/
       static double fatorialStirling (int n);
 
+      //Passos da programação dinâmica de Held-Karp com n genes livres: n².2^n
+      static double esforcoHeldKarp (int n);
+
+      /************************************************************************************
+      Cada thread tem o seu gerador (xorshift64*), no lugar do rand() global. As tarefas
+      paralelas recebem uma semente sorteada antes de começar e guardam o estado da
+      thread, para que o resultado não dependa de quantas threads existem nem de qual
+      thread executou cada tarefa.
+      ************************************************************************************/
       static void initRnd ();
+      static void initRnd (uint64_t semente);
+      static uint64_t sorteiaSemente ();
+      static uint64_t get_estadoRnd ();
+      static void set_estadoRnd (uint64_t estado);
 		static void set_calibraRndD(unsigned max);
       static int rnd(unsigned low, unsigned high);
 		static double rndd(double low, double high);